@@ -37,6 +37,53 @@ namespace lsp
             static constexpr size_t RATE_MAX            = 10;
             static constexpr size_t RATE_DFL            = 5;
             static constexpr size_t RATE_STEP           = 1;
+
+            static constexpr float  LOOP_LEN_MIN        = 1.0f;
+            static constexpr float  LOOP_LEN_MAX        = 600.0f;
+            static constexpr float  LOOP_LEN_DFL        = 10.0f;
+            static constexpr float  LOOP_LEN_STEP       = 0.1f;
+
+            static constexpr float  FILE_LEN_MAX        = 60.0f;
+
+            static constexpr ssize_t MIDI_NUM_MIN       = -1;
+            static constexpr size_t MIDI_NUM_MAX        = 127;
+            static constexpr size_t MIDI_NUM_STEP       = 1;
+            static constexpr size_t MIDI_SEL_DFL        = 60;
+            static constexpr size_t MIDI_BLIND_DFL      = 72;
+            static constexpr size_t MIDI_SHUFFLE_DFL    = 73;
+            static constexpr size_t MIDI_MONO_DFL       = 74;
+
+            static constexpr size_t OSC_PORT_MIN        = 1024;
+            static constexpr size_t OSC_PORT_MAX        = 65535;
+            static constexpr size_t OSC_PORT_DFL        = 9000;
+            static constexpr size_t OSC_PORT_STEP       = 1;
+
+            static constexpr float  DSP_LOAD_MIN        = 0.0f;
+            static constexpr float  DSP_LOAD_MAX        = 100.0f;
+            static constexpr float  DSP_LOAD_DFL        = 0.0f;
+            static constexpr float  DSP_LOAD_STEP       = 0.1f;
+
+            static constexpr size_t INPUTS_MIN          = 2;
+            static constexpr size_t INPUTS_STEP         = 1;
+
+            enum loop_mode_t
+            {
+                LOOP_LIVE,
+                LOOP_CAPTURE,
+                LOOP_REPLAY
+            };
+
+            enum midi_type_t
+            {
+                MIDI_NOTE,
+                MIDI_CC
+            };
+
+            enum osc_iface_t
+            {
+                OSC_LOOPBACK,
+                OSC_ANY
+            };
         } ab_tester;
 
         // Plugin type metadata
@@ -23,8 +23,16 @@
 #define PRIVATE_PLUGINS_AB_TESTER_H_
 
 #include <lsp-plug.in/dsp-units/ctl/Bypass.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <lsp-plug.in/ipc/ITask.h>
 #include <lsp-plug.in/plug-fw/plug.h>
+#include <lsp-plug.in/protocol/midi.h>
 #include <private/meta/ab_tester.h>
+#include <private/plugins/capture_spill.h>
+#include <private/plugins/gain_smoother.h>
+#include <private/plugins/osc_listener.h>
+#include <private/plugins/process_timer.h>
+#include <private/plugins/trial_journal.h>
 
 namespace lsp
 {
@@ -40,18 +48,68 @@ namespace lsp
                 ab_tester (const ab_tester &);
 
             protected:
+                struct afile_t;
+
+                class FileLoader: public ipc::ITask
+                {
+                    private:
+                        ab_tester          *pCore;
+                        afile_t            *pFile;
+
+                    public:
+                        explicit FileLoader(ab_tester *core, afile_t *file);
+                        virtual ~FileLoader() override;
+
+                    public:
+                        virtual status_t    run() override;
+                };
+
+                class LoopAllocator: public ipc::ITask
+                {
+                    private:
+                        ab_tester          *pCore;
+
+                    public:
+                        explicit LoopAllocator(ab_tester *core);
+                        virtual ~LoopAllocator() override;
+
+                    public:
+                        virtual status_t    run() override;
+                };
+
+                typedef struct afile_t
+                {
+                    FileLoader         *pLoader;    // File loader task
+                    dspu::Sample       *pSample;    // Active sample used for playback
+                    dspu::Sample       *pLoaded;    // Loaded sample or previously active sample to destroy
+                    bool                bReload;    // Reload file with new sample rate
+
+                    plug::IPort        *pFile;      // File path port
+                } afile_t;
+
                 typedef struct in_channel_t
                 {
                     dspu::Bypass        sBypass;    // Bypass
-                    float              *vIn;        // Input data
+                    const float        *vIn;        // Input data
                     float              *vRet;       // Return data
-                    float               fOldGain;   // Old gain value
-                    float               fGain;      // Input gain
+                    float              *vLoop;      // Loop capture buffer
+                    afile_t            *pFile;      // Input file
+                    gain_smoother       sGain;      // Input gain
+                    size_t              nRating;    // Rating
+                    float               fPortRating;// Last value of the rating port
+                    const float        *vSrc;       // Source data of the current block
+                    const float        *vSrcRet;    // Return data of the current block
+                    float              *vCapture;   // Capture destination of the current block
+                    size_t              nSrcStride; // Distance between source samples of the current block
+                    float               fLevel;     // Input level of the current block
+                    size_t              nDispLevel; // Level step shown by the inline display
 
                     plug::IPort        *pIn;        // Input data
                     plug::IPort        *pRet;       // Return data
                     plug::IPort        *pGain;      // Input gain
                     plug::IPort        *pInMeter;   // Input level meter
+                    plug::IPort        *pRating;    // Rating
+                    plug::IPort        *pBlindSel;  // Input takes part in the blind test
                 } in_channel_t;
 
                 typedef struct out_channel_t
@@ -63,21 +121,120 @@ namespace lsp
             protected:
                 in_channel_t       *vInChannels;    // Input channels
                 out_channel_t      *vOutChannels;   // Output channels
+                afile_t            *vFiles;         // Input files
+                capture_spill       sSpill;         // On-disk storage for long loops
+                trial_journal       sJournal;       // Journal of blind test trials
+                osc_listener        sOsc;           // OSC control endpoint
+                process_timer       sTimer;         // Timing counters of the processing path
+                ipc::IExecutor     *pExecutor;      // Executor service
                 size_t              nInChannels;    // Number of input channels
                 size_t              nOutChannels;   // Number of output channels
+                size_t              nFiles;         // Number of input files
+                size_t              nInStride;      // Distance between input samples, 1 for planar data
+                size_t              nOutStride;     // Distance between output samples, 1 for planar data
                 float              *vTmp;           // Temporary buffer
                 bool                bBlindTest;     // Blind test mode
                 bool                bMono;          // Mono listen mode
                 size_t              nSelector;      // Selector
+                size_t              nLoopMode;      // Loop capture mode
+                size_t              nLoopCap;       // Capacity of the loop buffer per channel
+                size_t              nLoopRamMax;    // Maximum capacity of the loop buffer per channel
+                size_t              nLoopRequest;   // Requested capacity of the loop buffer per channel
+                bool                bLoopArmed;     // Capture waits for the loop buffer to be allocated
+                size_t              nLoopLength;    // Requested loop length in samples
+                size_t              nLoopSize;      // Number of captured samples
+                size_t              nLoopPos;       // Current loop replay position
+                size_t              nLoopLimit;     // Maximum number of samples for current capture
+                bool                bLoopSpill;     // Current loop is stored on disk
+                bool                bFilePlay;      // File playback is enabled
+                size_t              nFilePos;       // Current file playback position
+                size_t              nFileLength;    // Length of the longest loaded file
+                bool                bJournal;       // Journal is enabled
+                uint32_t            nShuffle;       // Last shuffle permutation written to the journal
+                size_t              nShufflePoll;   // Number of samples left before next shuffle state poll
+                uint64_t            nClock;         // Number of samples processed since start
+                size_t              nMidiChannel;   // MIDI control channel, 0 means any channel
+                size_t              nMidiType;      // MIDI control message type
+                ssize_t             nMidiSel;       // MIDI note or CC of the channel selector
+                ssize_t             nMidiBlind;     // MIDI note or CC of the blind test switch
+                ssize_t             nMidiShuffle;   // MIDI note or CC of the re-shuffle trigger
+                ssize_t             nMidiMono;      // MIDI note or CC of the mono switch
+                uint32_t            nRandom;        // State of the random generator for shuffling
+                float               fPortSel;       // Last value of the channel selector port
+                float               fPortBlind;     // Last value of the blind test port
+                uint32_t            nBlindSet;      // Mask of inputs taking part in the blind test
+                float               fPortMono;      // Last value of the mono switch port
+                float               fPortShuffle;   // Last value of the re-shuffle trigger port
+                bool                bShufflePub;    // Shuffle permutation is pending for publishing to the UI
+                uint64_t            nRemotePub;     // State of switches and ratings last published to the UI
+                uint32_t            nLoadShuffle;   // Shuffle permutation restored with the state
+                uatomic_t           nStateLoaded;   // The state has been restored and is pending for apply
+                uint64_t            nStateReadTime; // Time spent reading the restored state from KVT, ns
+                size_t              nActive;        // Number of processed input channels
+                size_t              nDispSelector;  // Selector shown by the inline display
+                bool                bDispBlind;     // Blind test state shown by the inline display
 
                 plug::IPort        *pChannelSel;    // Channel selector
                 plug::IPort        *pBlindTest;     // Blind test switch
+                plug::IPort        *pShuffle;       // Re-shuffle trigger
                 plug::IPort        *pMono;          // Mono switch
+                plug::IPort        *pLoopMode;      // Loop capture mode
+                plug::IPort        *pLoopLength;    // Loop length
+                plug::IPort        *pLoopPos;       // Loop position
+                plug::IPort        *pFilePlay;      // File playback switch
+                plug::IPort        *pJournal;       // Journal enable
+                plug::IPort        *pJournalFile;   // Journal file
+                plug::IPort        *pMidiIn;        // MIDI input
+                plug::IPort        *pMidiChannel;   // MIDI control channel
+                plug::IPort        *pMidiType;      // MIDI control message type
+                plug::IPort        *pMidiSel;       // MIDI note or CC of the channel selector
+                plug::IPort        *pMidiBlind;     // MIDI note or CC of the blind test switch
+                plug::IPort        *pMidiShuffle;   // MIDI note or CC of the re-shuffle trigger
+                plug::IPort        *pMidiMono;      // MIDI note or CC of the mono switch
+                plug::IPort        *pOscOn;         // OSC listener enable
+                plug::IPort        *pOscIface;      // OSC listener interface
+                plug::IPort        *pOscPort;       // OSC listener port
+                plug::IPort        *pDspLoad;       // Average DSP load
+                plug::IPort        *pDspPeak;       // Peak DSP load
+                plug::IPort        *pInputs;        // Number of used inputs
 
+                LoopAllocator       sLoopAlloc;     // Loop capture arena allocator
                 uint8_t            *pData;          // All allocated data
+                size_t              nDataSize;      // Size of all allocated data
+                uint8_t            *pLoopData;      // Loop capture arena
+
+            protected:
+                static void         destroy_sample(dspu::Sample * &sample);
 
             protected:
                 void                do_destroy();
+                status_t            load_file(afile_t *af);
+                void                process_file_requests();
+                status_t            allocate_loop();
+                void                process_loop_requests();
+                void                start_capture();
+                void                free_loop();
+                void                process_journal(size_t samples);
+                void                start_journal();
+                void                do_process(size_t samples);
+                void                process_capture(in_channel_t *in, size_t samples);
+                void                process_gain(const in_channel_t *in, float *dst, size_t samples) const;
+                void                process_bypass(in_channel_t *in, float *dst, size_t samples);
+                void                update_display();
+                void                set_selector(size_t selector, size_t offset);
+                void                set_blind_test(bool blind, size_t offset);
+                size_t              blind_inputs(uint32_t *items) const;
+                bool                shuffle(size_t offset);
+                void                publish_shuffle();
+                uint64_t            remote_state() const;
+                void                publish_remote_state(uint64_t state);
+                void                apply_loaded_state();
+                size_t              blind_channel(size_t index) const;
+                size_t              remote_inputs() const;
+                bool                midi_overlap() const;
+                void                process_midi_event(const midi::event_t *ev, size_t offset);
+                void                process_osc_command(const osc_listener::command_t *cmd);
+                void                set_rating(size_t channel, size_t rating, size_t offset);
 
             public:
                 explicit ab_tester(const meta::plugin_t *meta);
@@ -90,7 +247,27 @@ namespace lsp
                 virtual void        update_sample_rate(long sr);
                 virtual void        update_settings();
                 virtual void        process(size_t samples);
+                virtual bool        inline_display(plug::ICanvas *cv, size_t width, size_t height);
+                virtual void        state_loaded();
                 virtual void        dump(dspu::IStateDumper *v) const;
+
+            public:
+                /**
+                 * Estimate the amount of memory used by the plugin instance
+                 * @return amount of memory in bytes
+                 */
+                size_t              footprint() const;
+
+            public:
+                /**
+                 * Process interleaved data directly without deinterleaving it into the port buffers.
+                 * Return links and other non-audio ports are taken from ports as usual.
+                 *
+                 * @param dst interleaved output frames, one sample per each audio output port
+                 * @param src interleaved input frames, one sample per each audio input port
+                 * @param samples number of frames to process
+                 */
+                void                process_interleaved(float *dst, const float *src, size_t samples);
         };
 
     } /* namespace plugins */
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_CAPTURE_SPILL_H_
+#define PRIVATE_PLUGINS_CAPTURE_SPILL_H_
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+#include <lsp-plug.in/ipc/IExecutor.h>
+#include <lsp-plug.in/ipc/ITask.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * On-disk planar storage for long multi-channel captures.
+         *
+         * The audio thread puts captured samples into the staging ring buffer, the
+         * background writer flushes the ring to the temporary file. The file contains
+         * one contiguous region of samples per channel and is memory-mapped for playback.
+         * The file is created and mapped by init(), so the caller can fall back to memory
+         * storage when it is not available. The storage is not used anymore after a write
+         * error, capacity() returns zero then.
+         *
+         * The background prefetcher locks the pages ahead of the read position in memory
+         * and publishes the resident window, the audio thread reads only the published
+         * window and gets silence for any other range. If the pages can not be locked
+         * (for example, because of RLIMIT_MEMLOCK), the prefetcher only touches them and
+         * raises the flag, under memory pressure the audio thread may wait for the disk
+         * read then.
+         *
+         * All methods marked as RT-safe can be called from the audio thread, all other
+         * methods should be called from the non-realtime thread only.
+         */
+        class capture_spill
+        {
+            private:
+                capture_spill & operator = (const capture_spill &);
+                capture_spill(const capture_spill &);
+
+            protected:
+                class Writer: public ipc::ITask
+                {
+                    private:
+                        capture_spill      *pSpill;
+
+                    public:
+                        explicit Writer(capture_spill *spill);
+                        virtual ~Writer() override;
+
+                    public:
+                        virtual status_t    run() override;
+                };
+
+                class Prefetcher: public ipc::ITask
+                {
+                    private:
+                        capture_spill      *pSpill;
+
+                    public:
+                        explicit Prefetcher(capture_spill *spill);
+                        virtual ~Prefetcher() override;
+
+                    public:
+                        virtual status_t    run() override;
+                };
+
+                typedef struct range_t
+                {
+                    uint8_t            *pFirst;         // First byte of the page range
+                    uint8_t            *pLast;          // Last byte of the page range (exclusive)
+                } range_t;
+
+                typedef struct window_t
+                {
+                    size_t              nFirst;         // First resident sample
+                    size_t              nLast;          // Last resident sample (exclusive)
+                    size_t              nWrap;          // Resident samples at the beginning after wrap
+                } window_t;
+
+            protected:
+                Writer              sWriter;        // Background writer
+                Prefetcher          sPrefetcher;    // Background prefetcher
+                size_t              nChannels;      // Number of channels
+                size_t              nCapacity;      // Capacity of the file per channel in samples
+                size_t              nRingSize;      // Size of the staging ring per channel in samples
+                size_t              nPrefetch;      // Number of samples to prefetch ahead of read position
+                float              *vRing;          // Staging ring buffers
+                range_t            *vLocked;        // Page ranges currently locked by the prefetcher
+                range_t            *vLockNew;       // Page ranges of the new window
+                size_t              nLocked;        // Number of locked page ranges
+                size_t              nLockNew;       // Number of page ranges of the new window
+                uint8_t            *pData;          // Allocated data
+
+                int                 hFD;            // File descriptor
+                float              *vMap;           // Memory-mapped file contents
+                size_t              nMapSize;       // Size of the mapping in bytes
+                size_t              nPageSize;      // Size of the memory page
+
+                uatomic_t           nHead;          // Number of samples committed by the audio thread
+                uatomic_t           nFlushed;       // Number of samples flushed to the file
+                uatomic_t           nReset;         // Reset request
+                uatomic_t           nFailed;        // Spill file could not be written
+                uatomic_t           nReadPos;       // Current read position
+                uatomic_t           nReadSize;      // Current size of the loop
+                uatomic_t           nResSeq;        // Sequence counter of the resident window, odd while updated
+                uatomic_t           nResFirst;      // First resident sample
+                uatomic_t           nResLast;       // Last resident sample (exclusive)
+                uatomic_t           nResWrap;       // Resident samples at the beginning after wrap
+                uatomic_t           nUnlocked;      // The resident window could not be locked
+                uatomic_t           nMisses;        // Number of reads replaced by silence
+
+            protected:
+                status_t            open_file();
+                void                close_file();
+                void                wait_tasks();
+                void                touch_range(size_t first, size_t last);
+                size_t              page_range(range_t *dst, size_t channel, size_t first, size_t last) const;
+                bool                lock_pages(const range_t *list, size_t count);
+                void                unlock_pages(uint8_t *first, uint8_t *last, size_t index);
+                void                publish_window(size_t first, size_t last, size_t wrap);
+                bool                resident_window(window_t *w) const;
+
+                status_t            do_flush();
+                status_t            do_prefetch();
+
+            public:
+                explicit capture_spill();
+                ~capture_spill();
+
+                /**
+                 * Initialize spill storage, create and map the temporary file
+                 * @param channels number of channels
+                 * @param capacity maximum number of samples per channel
+                 * @param ring size of the staging ring buffer per channel in samples
+                 * @param prefetch number of samples to keep resident ahead of read position
+                 * @return status of operation
+                 */
+                status_t            init(size_t channels, size_t capacity, size_t ring, size_t prefetch);
+
+                /**
+                 * Destroy spill storage, wait for background tasks and remove the file
+                 */
+                void                destroy();
+
+            public:
+                /**
+                 * Get the capacity of the storage, RT-safe
+                 * @return capacity of the storage per channel in samples, zero if storage is not available
+                 */
+                size_t              capacity() const;
+
+                /**
+                 * Start new capture, RT-safe
+                 */
+                void                reset();
+
+                /**
+                 * Get the number of samples that can be written contiguously to the staging ring, RT-safe
+                 * @param pos the capture position
+                 * @return number of samples available for write
+                 */
+                size_t              write_limit(size_t pos) const;
+
+                /**
+                 * Get the pointer to the staging ring buffer, RT-safe
+                 * @param channel channel index
+                 * @param pos the capture position
+                 * @return pointer to the ring buffer, should be filled with at most write_limit() samples
+                 */
+                float              *ring(size_t channel, size_t pos);
+
+                /**
+                 * Commit captured data for the flush, RT-safe
+                 * @param pos new capture position
+                 */
+                void                commit(size_t pos);
+
+                /**
+                 * Set the current read position for the prefetcher, RT-safe
+                 * @param pos read position
+                 * @param size size of the loop
+                 */
+                void                set_position(size_t pos, size_t size);
+
+                /**
+                 * Get pointer to the prefetched data, RT-safe
+                 * @param channel channel index
+                 * @param pos read position
+                 * @param count number of samples to read
+                 * @return pointer to the data or NULL if data is not flushed or not resident,
+                 *   the miss is counted then
+                 */
+                const float        *read(size_t channel, size_t pos, size_t count);
+
+                /**
+                 * Submit background tasks if there is a pending job, RT-safe
+                 * @param executor executor service
+                 * @param prefetch the capture is not active and the data at the read position should be kept resident
+                 */
+                void                submit(ipc::IExecutor *executor, bool prefetch);
+
+                /**
+                 * Estimate the amount of memory allocated by the storage, the contents of the spill file are not counted
+                 * @return amount of memory in bytes
+                 */
+                size_t              footprint() const;
+
+                /**
+                 * Dump the state
+                 * @param v state dumper
+                 */
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_CAPTURE_SPILL_H_ */
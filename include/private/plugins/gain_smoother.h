@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_PLUGINS_GAIN_SMOOTHER_H_
+#define PRIVATE_PLUGINS_GAIN_SMOOTHER_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Gain smoother with the fixed ramp time.
+         *
+         * The change of the gain is spread over SMOOTH_TIME seconds regardless of the
+         * block size, so the ramp may span several blocks. Once the ramp completes, the
+         * gain is applied by plain multiplication or by copying at the unity gain.
+         *
+         * The ramp is applied to several buffers of the block with the same state by
+         * calls to apply() and apply_add(), then the state is moved forward by advance().
+         */
+        class gain_smoother
+        {
+            private:
+                gain_smoother & operator = (const gain_smoother &);
+                gain_smoother(const gain_smoother &);
+
+            public:
+                static constexpr float  SMOOTH_TIME     = 0.005f;
+
+            protected:
+                float               fCurrent;       // Current gain
+                float               fTarget;        // Target gain
+                float               fDelta;         // Gain increment per sample
+                size_t              nLeft;          // Number of samples left till the end of the ramp
+                size_t              nLength;        // Length of the ramp in samples
+
+            public:
+                explicit gain_smoother();
+                ~gain_smoother();
+
+                /**
+                 * Construct the object allocated in raw memory
+                 */
+                void                construct();
+
+                /**
+                 * Set the sample rate, the pending ramp completes immediately
+                 * @param sr sample rate
+                 */
+                void                set_sample_rate(size_t sr);
+
+                /**
+                 * Set the gain without smoothing
+                 * @param gain gain value
+                 */
+                void                reset(float gain);
+
+                /**
+                 * Start the ramp to the new gain from the current gain
+                 * @param gain new gain value
+                 */
+                void                set(float gain);
+
+            public:
+                /**
+                 * Apply the gain: dst = src * gain, dst may be equal to src
+                 * @param dst destination buffer
+                 * @param src source buffer
+                 * @param count number of samples
+                 */
+                void                apply(float *dst, const float *src, size_t count) const;
+
+                /**
+                 * Apply the gain and add to the destination: dst = dst + src * gain
+                 * @param dst destination buffer
+                 * @param src source buffer
+                 * @param count number of samples
+                 */
+                void                apply_add(float *dst, const float *src, size_t count) const;
+
+                /**
+                 * Move the state forward after the block has been processed
+                 * @param count number of samples
+                 */
+                void                advance(size_t count);
+
+            public:
+                inline float        gain() const        { return fCurrent;      }
+                inline float        target() const      { return fTarget;       }
+                inline bool         settled() const     { return nLeft <= 0;    }
+
+                /**
+                 * Dump the state
+                 * @param v state dumper
+                 */
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_GAIN_SMOOTHER_H_ */
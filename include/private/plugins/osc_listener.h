@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_OSC_LISTENER_H_
+#define PRIVATE_PLUGINS_OSC_LISTENER_H_
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+#include <lsp-plug.in/ipc/IExecutor.h>
+#include <lsp-plug.in/ipc/ITask.h>
+#include <lsp-plug.in/ipc/Thread.h>
+#include <lsp-plug.in/runtime/system.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * OSC control endpoint.
+         *
+         * The listener thread receives OSC messages from the UDP socket bound to the
+         * local interface and puts decoded commands into the lock-free single-producer
+         * single-consumer queue. The audio thread only configures the listener and
+         * fetches commands from the queue, it never touches the socket.
+         *
+         * Supported messages:
+         *   /ab_tester/sel <index>             - select the channel, 0 mutes the output
+         *   /ab_tester/rate <index> <rating>   - set the rating of the channel
+         */
+        class osc_listener
+        {
+            private:
+                osc_listener & operator = (const osc_listener &);
+                osc_listener(const osc_listener &);
+
+            public:
+                enum command_type_t
+                {
+                    CMD_SELECT,             // Select the channel
+                    CMD_RATING              // Set the rating of the channel
+                };
+
+                typedef struct command_t
+                {
+                    uint32_t            nCommand;       // Command type
+                    uint32_t            nChannel;       // Channel number, zero if not applicable
+                    uint32_t            nValue;         // Command value
+                    uint32_t            nPad;           // Padding
+                } command_t;
+
+            protected:
+                class Starter: public ipc::ITask
+                {
+                    private:
+                        osc_listener       *pListener;
+
+                    public:
+                        explicit Starter(osc_listener *listener);
+                        virtual ~Starter() override;
+
+                    public:
+                        virtual status_t    run() override;
+                };
+
+                class Listener: public ipc::Thread
+                {
+                    private:
+                        osc_listener       *pListener;
+
+                    public:
+                        explicit Listener(osc_listener *listener);
+                        virtual ~Listener() override;
+
+                    public:
+                        virtual status_t    run() override;
+                };
+
+            protected:
+                Starter             sStarter;       // Task that launches the listener thread
+                Listener           *pThread;        // Listener thread
+                command_t          *vCommands;      // Queue of commands
+                size_t              nCapacity;      // Capacity of the queue, power of two
+                uatomic_t           nHead;          // Number of commands pushed by the listener
+                uatomic_t           nTail;          // Number of commands fetched by the audio thread
+                uatomic_t           nDropped;       // Number of commands dropped due to queue overflow
+                uatomic_t           nConfig;        // Requested configuration of the socket
+                uatomic_t           nStop;          // Stop request for the listener thread
+                system::time_millis_t nRetryTime;   // Time of the next attempt to start the failed listener thread
+
+            protected:
+                status_t            do_start();
+                status_t            do_listen();
+                void                parse_packet(const uint8_t *data, size_t size);
+                void                parse_message(const uint8_t *data, size_t size);
+                bool                push(uint32_t command, uint32_t channel, uint32_t value);
+
+            public:
+                explicit osc_listener();
+                ~osc_listener();
+
+                /**
+                 * Initialize the listener, the listener thread is not started until enabled
+                 * @param capacity capacity of the command queue
+                 * @return status of operation
+                 */
+                status_t            init(size_t capacity);
+
+                /**
+                 * Destroy the listener, stop the listener thread and close the socket
+                 */
+                void                destroy();
+
+            public:
+                /**
+                 * Set the configuration of the listener, RT-safe
+                 * @param enabled enable the listener
+                 * @param any listen on all interfaces instead of the loopback interface
+                 * @param port UDP port number
+                 */
+                void                configure(bool enabled, bool any, uint16_t port);
+
+                /**
+                 * Fetch the next command from the queue, RT-safe
+                 * @param cmd pointer to store the command
+                 * @return true if the command has been fetched
+                 */
+                bool                fetch(command_t *cmd);
+
+                /**
+                 * Launch the listener thread if it has been enabled, RT-safe
+                 * @param executor executor service
+                 */
+                void                submit(ipc::IExecutor *executor);
+
+                /**
+                 * Estimate the amount of memory allocated by the listener
+                 * @return amount of memory in bytes
+                 */
+                size_t              footprint() const;
+
+                /**
+                 * Dump the state
+                 * @param v state dumper
+                 */
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_OSC_LISTENER_H_ */
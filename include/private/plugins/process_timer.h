@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_PROCESS_TIMER_H_
+#define PRIVATE_PLUGINS_PROCESS_TIMER_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Always-on timing counters of the processing path.
+         *
+         * The total time, the worst call time and the number of processed samples are
+         * measured on each call. The time spent in each processing stage is measured
+         * only on each STAGE_PERIOD-th call to keep the cost of reading the clock low,
+         * so stage times should be compared to the number of samples they cover.
+         */
+        class process_timer
+        {
+            private:
+                process_timer & operator = (const process_timer &);
+                process_timer(const process_timer &);
+
+            public:
+                enum stage_t
+                {
+                    STAGE_GAIN,             // Source fetch, gain ramp and return mixing
+                    STAGE_BYPASS,           // Metering and bypass
+                    STAGE_MIX,              // Mixing to the output
+                    STAGE_MONO,             // Mono switch
+
+                    STAGE_TOTAL
+                };
+
+                static constexpr size_t STAGE_PERIOD    = 16;
+
+            protected:
+                uint64_t            nCalls;                 // Number of calls
+                uint64_t            nSamples;               // Number of processed samples
+                uint64_t            nTime;                  // Total time spent in processing, ns
+                uint64_t            nWorst;                 // Worst call time, ns
+                size_t              nWorstSamples;          // Number of samples of the worst call
+                uint64_t            vStages[STAGE_TOTAL];   // Time spent in each stage, ns
+                uint64_t            nStageSamples;          // Number of samples covered by stage times
+                uint64_t            nStart;                 // Start time of the current call
+                uint64_t            nMark;                  // Time of the last stage mark
+                bool                bStages;                // Stages are measured in the current call
+
+                size_t              nSampleRate;            // Sample rate
+                size_t              nWindow;                // Length of the load measurement window in samples
+                uint64_t            nWinTime;               // Time spent in the current window, ns
+                size_t              nWinSamples;            // Number of samples in the current window
+                float               fWinPeak;               // Peak load of the call in the current window
+                float               fLoad;                  // Average load of the last window
+                float               fPeak;                  // Peak load of the last window
+
+            public:
+                static uint64_t     now();
+
+            public:
+                explicit process_timer();
+                ~process_timer();
+
+                /**
+                 * Reset all counters
+                 */
+                void                reset();
+
+                /**
+                 * Update the sample rate, resets the load measurement window
+                 * @param sr sample rate
+                 */
+                void                set_sample_rate(size_t sr);
+
+            public:
+                /**
+                 * Start measuring the call
+                 */
+                inline void         begin()
+                {
+                    nStart          = now();
+                    nMark           = nStart;
+                    bStages         = (nCalls % STAGE_PERIOD) == 0;
+                }
+
+                /**
+                 * Start measuring a sequence of stages, the time since the last mark is not accounted
+                 */
+                inline void         restart()
+                {
+                    if (bStages)
+                        nMark           = now();
+                }
+
+                /**
+                 * Account the time since the last mark to the stage
+                 * @param stage stage identifier
+                 */
+                inline void         mark(size_t stage)
+                {
+                    if (!bStages)
+                        return;
+                    const uint64_t t    = now();
+                    vStages[stage]     += t - nMark;
+                    nMark               = t;
+                }
+
+                /**
+                 * Finish measuring the call
+                 * @param samples number of samples processed by the call
+                 */
+                void                end(size_t samples);
+
+            public:
+                inline uint64_t     calls() const       { return nCalls;    }
+                inline uint64_t     samples() const     { return nSamples;  }
+                inline uint64_t     time() const        { return nTime;     }
+                inline uint64_t     worst() const       { return nWorst;    }
+
+                /**
+                 * Get the average DSP load of the last measurement window
+                 * @return load in percents of the real-time budget
+                 */
+                inline float        load() const        { return fLoad;     }
+
+                /**
+                 * Get the peak DSP load of a single call in the last measurement window
+                 * @return load in percents of the real-time budget
+                 */
+                inline float        peak() const        { return fPeak;     }
+
+                /**
+                 * Dump the state
+                 * @param v state dumper
+                 */
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_PROCESS_TIMER_H_ */
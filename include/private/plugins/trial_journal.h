@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_TRIAL_JOURNAL_H_
+#define PRIVATE_PLUGINS_TRIAL_JOURNAL_H_
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+#include <lsp-plug.in/ipc/IExecutor.h>
+#include <lsp-plug.in/ipc/ITask.h>
+#include <lsp-plug.in/runtime/system.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Journal of blind test trials.
+         *
+         * The audio thread pushes fixed-size records into the lock-free single-producer
+         * single-consumer queue, the background writer formats them as CSV lines and
+         * appends them to the journal file. Records stay in the queue while the file is
+         * not open, the failed open is retried periodically. Records that do not fit
+         * into the queue are counted and reported in the file as dropped.
+         */
+        class trial_journal
+        {
+            private:
+                trial_journal & operator = (const trial_journal &);
+                trial_journal(const trial_journal &);
+
+            public:
+                enum event_t
+                {
+                    EV_START,               // Journal has been started, value is sample rate
+                    EV_SELECT,              // Channel selector has changed
+                    EV_RATING,              // Channel rating has changed
+                    EV_BLIND,               // Blind test mode has been toggled
+                    EV_SHUFFLE              // Channels have been shuffled, value is permutation
+                };
+
+                typedef struct record_t
+                {
+                    uint64_t            nPosition;      // Position in samples since the plugin start
+                    uint32_t            nEvent;         // Event type
+                    uint32_t            nChannel;       // Channel number, zero if not applicable
+                    uint32_t            nValue;         // Event value
+                    uint32_t            nPad;           // Padding
+                } record_t;
+
+            protected:
+                class Writer: public ipc::ITask
+                {
+                    private:
+                        trial_journal      *pJournal;
+
+                    public:
+                        explicit Writer(trial_journal *journal);
+                        virtual ~Writer() override;
+
+                    public:
+                        virtual status_t    run() override;
+                };
+
+            protected:
+                Writer              sWriter;        // Background writer
+                record_t           *vRecords;       // Queue of records
+                size_t              nCapacity;      // Capacity of the queue, power of two
+                uatomic_t           nHead;          // Number of records pushed by the audio thread
+                uatomic_t           nTail;          // Number of records written by the background writer
+                uatomic_t           nDropped;       // Number of records dropped due to queue overflow
+                uatomic_t           nNewPath;       // New file path has been set and the file is pending for open
+                uatomic_t           nOpened;        // Journal file is open
+                FILE               *hFile;          // Journal file
+                system::time_millis_t   nRetryTime; // Time of the next attempt to open the file, owned by submit()
+                bool                bOpenFailed;    // The file could not be opened, the failure has been reported
+                char                sPath[PATH_MAX];// Path to the journal file
+
+            protected:
+                status_t            do_write();
+                void                write_record(const record_t *r);
+
+            public:
+                explicit trial_journal();
+                ~trial_journal();
+
+                /**
+                 * Initialize journal
+                 * @param capacity capacity of the record queue
+                 * @return status of operation
+                 */
+                status_t            init(size_t capacity);
+
+                /**
+                 * Destroy journal, wait for the writer and close the file
+                 */
+                void                destroy();
+
+            public:
+                /**
+                 * Check that the journal is ready to accept new file path, RT-safe
+                 * @return true if the journal is ready to accept new file path
+                 */
+                bool                idle() const;
+
+                /**
+                 * Set the path to the journal file, should be called only when idle() is true, RT-safe
+                 * @param path path to the file, empty path closes the journal file
+                 */
+                void                set_path(const char *path);
+
+                /**
+                 * Push record to the journal, RT-safe
+                 * @param position position in samples
+                 * @param event event type
+                 * @param channel channel number
+                 * @param value event value
+                 * @return true if record has been pushed
+                 */
+                bool                push(uint64_t position, event_t event, uint32_t channel, uint32_t value);
+
+                /**
+                 * Submit the writer if there are pending records, RT-safe. The failed attempt
+                 * to open the journal file is repeated after the delay, not on each call
+                 * @param executor executor service
+                 */
+                void                submit(ipc::IExecutor *executor);
+
+                /**
+                 * Estimate the amount of memory allocated by the journal
+                 * @return amount of memory in bytes
+                 */
+                size_t              footprint() const;
+
+                /**
+                 * Dump the state
+                 * @param v state dumper
+                 */
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_TRIAL_JOURNAL_H_ */
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_SHARED_TRACER_H_
+#define PRIVATE_SHARED_TRACER_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/common/types.h>
+
+/*
+ * Scoped tracepoints are available only in debug builds, in release builds
+ * they are compiled to nothing. The tracer is the part of the shared object,
+ * so tracepoints can be used by both the plugin and the UI.
+ */
+#ifdef LSP_DEBUG
+    #define LSP_AB_TESTER_TRACE
+#endif /* LSP_DEBUG */
+
+#ifdef LSP_AB_TESTER_TRACE
+    #define AB_TRACE_CONCAT_(a, b)      a ## b
+    #define AB_TRACE_CONCAT(a, b)       AB_TRACE_CONCAT_(a, b)
+
+    /**
+     * Record the time spent in the enclosing scope
+     * @param name static string with the name of the tracepoint
+     */
+    #define AB_TRACE_SCOPE(name)        ::lsp::tracer::scope AB_TRACE_CONCAT(__ab_trace_, __LINE__)(name)
+#else
+    #define AB_TRACE_SCOPE(name)
+#endif /* LSP_AB_TESTER_TRACE */
+
+#ifdef LSP_AB_TESTER_TRACE
+namespace lsp
+{
+    namespace tracer
+    {
+        /**
+         * Scoped tracepoint: records the event to the ring buffer of the current thread
+         * when leaving the scope. Events are recorded only after the first instance has
+         * been attached. The ring is bound to the thread with the thread-specific key,
+         * so recording does not allocate memory for the first keys of the process
+         * (glibc keeps them in the thread descriptor). The ring is released when the
+         * thread exits and is reused by the next traced thread.
+         */
+        class scope
+        {
+            private:
+                scope & operator = (const scope &);
+                scope(const scope &);
+
+            private:
+                const char         *pName;
+                uint64_t            nStart;
+
+            public:
+                explicit scope(const char *name);
+                ~scope();
+        };
+
+        /**
+         * Get the time of the monotonic clock used by tracepoints
+         * @return time in nanoseconds
+         */
+        uint64_t    now();
+
+        /**
+         * Record the event to the ring buffer of the current thread
+         * @param name static string with the name of the event
+         * @param start start time of the event in nanoseconds
+         * @param end end time of the event in nanoseconds
+         */
+        void        record(const char *name, uint64_t start, uint64_t end);
+
+        /**
+         * Register the traced plugin or UI instance, should be called outside of the audio thread
+         */
+        void        attach();
+
+        /**
+         * Unregister the traced plugin or UI instance, the last instance exports recorded
+         * events to the file set by the LSP_AB_TESTER_TRACE_FILE environment variable
+         * @param suffix suffix of the file name, the plugin and the UI built as separate
+         *   binaries have own copies of the tracer and export own events
+         */
+        void        detach(const char *suffix);
+
+        /**
+         * Export recorded events of all threads in the Chrome trace event format
+         * that can be loaded by chrome://tracing or Perfetto UI
+         * @param path path to the output JSON file
+         * @return status of operation
+         */
+        status_t    export_chrome(const char *path);
+
+    } /* namespace tracer */
+} /* namespace lsp */
+#endif /* LSP_AB_TESTER_TRACE */
+
+#endif /* PRIVATE_SHARED_TRACER_H_ */
@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_TEST_OFFLINE_HOST_H_
+#define PRIVATE_TEST_OFFLINE_HOST_H_
+
+#include <lsp-plug.in/ipc/IExecutor.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/plug-fw/core/AudioBuffer.h>
+#include <lsp-plug.in/plug-fw/meta/func.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/plugins/ab_tester.h>
+
+namespace lsp
+{
+    namespace test
+    {
+        /**
+         * Executor that runs tasks in the caller's thread: immediately or deferred
+         * until run_tasks() is called, like a background executor between two
+         * process() calls
+         */
+        class offline_executor: public ipc::IExecutor
+        {
+            protected:
+                enum { MAX_TASKS = 32 };
+
+            protected:
+                ipc::ITask     *vTasks[MAX_TASKS];
+                size_t          nTasks;
+                bool            bDeferred;
+
+            public:
+                explicit offline_executor(bool deferred = false)
+                {
+                    nTasks      = 0;
+                    bDeferred   = deferred;
+                }
+
+            public:
+                virtual bool submit(ipc::ITask *task) override
+                {
+                    if (!bDeferred)
+                    {
+                        run_task(task);
+                        return true;
+                    }
+
+                    if (nTasks >= MAX_TASKS)
+                        return false;
+                    vTasks[nTasks++]    = task;
+                    return true;
+                }
+
+                virtual void shutdown() override
+                {
+                    run_tasks();
+                }
+
+            public:
+                void run_tasks()
+                {
+                    for (size_t i=0; i<nTasks; ++i)
+                        run_task(vTasks[i]);
+                    nTasks      = 0;
+                }
+        };
+
+        /**
+         * Port that holds the value or the pointer to the buffer provided by the host
+         */
+        class offline_port: public plug::IPort
+        {
+            protected:
+                float           fValue;
+                void           *pBuffer;
+
+            public:
+                explicit offline_port(const meta::port_t *meta): plug::IPort(meta)
+                {
+                    fValue      = meta->start;
+                    pBuffer     = NULL;
+                }
+
+            public:
+                virtual float value() override                  { return fValue;        }
+                virtual float default_value() override          { return pMetadata->start; }
+                virtual void set_value(float value) override    { fValue = value;       }
+                virtual void *buffer() override                 { return pBuffer;       }
+
+            public:
+                inline void bind(void *buffer)                  { pBuffer = buffer;     }
+        };
+
+        /**
+         * Wrapper that does not need any GUI, audio server or host
+         */
+        class offline_wrapper: public plug::IWrapper
+        {
+            protected:
+                offline_executor    sExecutor;
+
+            public:
+                explicit offline_wrapper(plug::Module *plugin, bool deferred):
+                    plug::IWrapper(plugin, NULL),
+                    sExecutor(deferred)
+                {
+                }
+
+            public:
+                virtual ipc::IExecutor *executor() override     { return &sExecutor;    }
+                inline void run_tasks()                         { sExecutor.run_tasks(); }
+        };
+
+        /**
+         * Offline host for the A/B tester plugin: instantiates the plugin for the
+         * specified metadata and drives it from the calling thread
+         */
+        class offline_host
+        {
+            protected:
+                plugins::ab_tester             *pPlugin;
+                offline_wrapper                *pWrapper;
+                lltl::parray<offline_port>      vPorts;
+                lltl::parray<offline_port>      vInputs;
+                lltl::parray<offline_port>      vOutputs;
+                lltl::parray<offline_port>      vReturns;
+                bool                            bUpdate;
+                bool                            bDeferred;
+
+            public:
+                /**
+                 * Create offline host
+                 * @param deferred run background tasks only when run_tasks() is called
+                 */
+                explicit offline_host(bool deferred = false)
+                {
+                    pPlugin     = NULL;
+                    pWrapper    = NULL;
+                    bUpdate     = true;
+                    bDeferred   = deferred;
+                }
+
+                ~offline_host()
+                {
+                    destroy();
+                }
+
+            public:
+                status_t init(const meta::plugin_t *meta, long sample_rate)
+                {
+                    destroy();
+
+                    for (const meta::port_t *p = meta->ports; (p != NULL) && (p->id != NULL); ++p)
+                    {
+                        offline_port *port = new offline_port(p);
+                        if ((port == NULL) || (!vPorts.add(port)))
+                        {
+                            delete port;
+                            return STATUS_NO_MEM;
+                        }
+
+                        if (meta::is_audio_in_port(p))
+                            vInputs.add(port);
+                        else if (meta::is_audio_out_port(p))
+                            vOutputs.add(port);
+                        else if (!strncmp(p->id, "ret", 3))
+                            vReturns.add(port);
+                    }
+
+                    pPlugin     = new plugins::ab_tester(meta);
+                    if (pPlugin == NULL)
+                        return STATUS_NO_MEM;
+                    pWrapper    = new offline_wrapper(pPlugin, bDeferred);
+                    if (pWrapper == NULL)
+                        return STATUS_NO_MEM;
+
+                    pPlugin->init(pWrapper, reinterpret_cast<plug::IPort **>(vPorts.array()));
+                    pPlugin->set_sample_rate(sample_rate);
+                    pPlugin->activate();
+                    bUpdate     = true;
+
+                    return STATUS_OK;
+                }
+
+                void destroy()
+                {
+                    if (pWrapper != NULL)
+                        pWrapper->run_tasks();
+                    if (pPlugin != NULL)
+                    {
+                        pPlugin->deactivate();
+                        pPlugin->destroy();
+                        delete pPlugin;
+                        pPlugin     = NULL;
+                    }
+                    if (pWrapper != NULL)
+                    {
+                        delete pWrapper;
+                        pWrapper    = NULL;
+                    }
+
+                    for (size_t i=0, n=vPorts.size(); i<n; ++i)
+                        delete vPorts.uget(i);
+                    vPorts.flush();
+                    vInputs.flush();
+                    vOutputs.flush();
+                    vReturns.flush();
+                }
+
+            public:
+                inline plugins::ab_tester *plugin()             { return pPlugin;               }
+                inline size_t inputs() const                    { return vInputs.size();        }
+                inline size_t outputs() const                   { return vOutputs.size();       }
+                inline size_t returns() const                   { return vReturns.size();       }
+
+                offline_port *port(const char *id)
+                {
+                    for (size_t i=0, n=vPorts.size(); i<n; ++i)
+                    {
+                        offline_port *p = vPorts.uget(i);
+                        if (!strcmp(p->metadata()->id, id))
+                            return p;
+                    }
+                    return NULL;
+                }
+
+                inline void run_tasks()
+                {
+                    pWrapper->run_tasks();
+                }
+
+                inline void set_sample_rate(long sample_rate)
+                {
+                    pWrapper->run_tasks();
+                    pPlugin->set_sample_rate(sample_rate);
+                    bUpdate     = true;
+                }
+
+                inline void update_settings()
+                {
+                    pPlugin->update_settings();
+                    bUpdate     = false;
+                }
+
+                bool set(const char *id, float value)
+                {
+                    offline_port *p = port(id);
+                    if (p == NULL)
+                        return false;
+                    p->set_value(value);
+                    bUpdate     = true;
+                    return true;
+                }
+
+                inline void bind_input(size_t index, const float *buf)
+                {
+                    vInputs.uget(index)->bind(const_cast<float *>(buf));
+                }
+
+                inline void bind_output(size_t index, float *buf)
+                {
+                    vOutputs.uget(index)->bind(buf);
+                }
+
+                inline void bind_return(size_t index, core::AudioBuffer *buf)
+                {
+                    vReturns.uget(index)->bind(buf);
+                }
+
+                void process(size_t samples)
+                {
+                    if (bUpdate)
+                    {
+                        pPlugin->update_settings();
+                        bUpdate     = false;
+                    }
+                    pPlugin->process(samples);
+                }
+
+                void process_interleaved(float *dst, const float *src, size_t samples)
+                {
+                    if (bUpdate)
+                    {
+                        pPlugin->update_settings();
+                        bUpdate     = false;
+                    }
+                    pPlugin->process_interleaved(dst, src, samples);
+                }
+        };
+
+    } /* namespace test */
+} /* namespace lsp */
+
+#endif /* PRIVATE_TEST_OFFLINE_HOST_H_ */
@@ -23,8 +23,13 @@
 #define PRIVATE_UI_AB_TESTER_H_
 
 #include <lsp-plug.in/plug-fw/ui.h>
+#include <lsp-plug.in/runtime/system.h>
+#include <lsp-plug.in/lltl/darray.h>
 #include <lsp-plug.in/lltl/parray.h>
 
+#include <private/ui/channel_names.h>
+#include <private/ui/rating_bar.h>
+
 namespace lsp
 {
     namespace plugui
@@ -35,16 +40,11 @@ namespace lsp
         class ab_tester_ui: public ui::Module, public ui::IPortListener
         {
             protected:
-                typedef struct rating_t
-                {
-                    lltl::parray<tk::Button>    vButtons;
-                } rating_t;
-
                 typedef struct channel_t
                 {
-                    rating_t                    vRating[2];     // Rating indicator, blnd rating indicator
+                    ab_tester_ui               *pUI;            // Owner
+                    tk::RatingBar              *vRating[2];     // Rating indicator, blind rating indicator
                     size_t                      nIndex;         // Absolute index of the channel
-                    int                         nRandom;        // Random number for shuffling
 
                     tk::Edit                   *wName;          // Edit that holds channel name
                     tk::Label                  *wBlindLabel;    // Blind label marker
@@ -52,12 +52,29 @@ namespace lsp
                     tk::Widget                 *wBlindSelector; // Blind selector
                     tk::Widget                 *wBlindSeparator;// Blind separator
 
-                    bool                        bNameChanged;   // Indicator that channel name has changed
+                    bool                        bNameChanged;   // Channel name has changed and is pending for sync
 
                     ui::IPort                  *pEnable;        // Enable blind test
                     ui::IPort                  *pRating;        // Rating port
                 } channel_t;
 
+                enum port_handler_t
+                {
+                    PH_BLIND_TEST,                              // Blind test switch
+                    PH_SELECTOR,                                // Channel selector
+                    PH_RESET,                                   // Reset ratings
+                    PH_SHUFFLE,                                 // Re-shuffle channels
+                    PH_RATING,                                  // Rating of the channel
+                    PH_ENABLE                                   // Channel participates in the blind test
+                };
+
+                typedef struct port_binding_t
+                {
+                    ui::IPort                  *pPort;          // Port, NULL for empty slot
+                    port_handler_t              nHandler;       // Handler of the port
+                    channel_t                  *pChannel;       // Channel related to the port
+                } port_binding_t;
+
             protected:
                 size_t                      nInChannels;
                 size_t                      nOutChannels;
@@ -66,6 +83,8 @@ namespace lsp
                 ui::IPort                  *pReset;             // Reset port
                 ui::IPort                  *pShuffle;           // Shuffle port
                 ui::IPort                  *pBlindTest;         // Blind test
+                ui::IPort                  *pMono;              // Mono switch
+                ui::IPort                  *pInputs;            // Number of used inputs
 
                 tk::Grid                   *wBlindGrid;         // Grid with blind test widgets
                 tk::Button                 *wSelectAll;         // Select all channels button
@@ -73,24 +92,47 @@ namespace lsp
 
                 lltl::parray<channel_t>     vChannels;          // List of channels
                 lltl::parray<channel_t>     vShuffled;          // Shuffled channels
+                lltl::parray<channel_t>     vGridOrder;         // Channels in the order of rows of the blind grid
+                lltl::parray<channel_t>     vDirtyNames;        // Channels with names pending for sync
+                channel_names               sNames;             // Names of channels stored in the KVT
+                system::time_millis_t       nNameDeadline;      // Time of the pending channel name sync
+                uint32_t                    nLegacyNames;       // Mask of channels with names stored by previous versions
+                lltl::darray<port_binding_t> vPortMap;          // Open-addressing hash of port handlers
+                size_t                      nPortMask;          // Mask of the port hash
+                system::time_millis_t       nCreateTime;        // Time of the UI creation, ms
+                bool                        bBlindView;         // Blind test view has been built
+                bool                        bNamesBlob;         // Channel names have been received as a single blob
+                bool                        bRemoteApply;       // The state changed by MIDI or OSC is being applied
 
             protected:
-                static ssize_t      cmp_channels(const channel_t *a, const channel_t *b);
+                static inline size_t port_hash(const ui::IPort *port);
 
             protected:
                 channel_t          *create_channel(size_t channel_id);
-                void                set_channel_name(core::KVTStorage *kvt, int id, const char *name);
+                bool                submit_channel_names(core::KVTStorage *kvt);
+                void                remove_legacy_names(core::KVTStorage *kvt);
                 void                sync_channel_names(core::KVTStorage *kvt);
-
+                void                apply_channel_names();
+                void                channel_name_changed(channel_t *ch);
+                bool                build_port_map();
+                bool                add_port_binding(ui::IPort *port, port_handler_t handler, channel_t *ch);
+                const port_binding_t *find_port_binding(const ui::IPort *port) const;
+
+                tk::Widget         *find_widget(const char *prefix, size_t index);
+                ui::IPort          *find_port(const char *prefix, size_t index);
+                tk::RatingBar      *create_rating(const char *prefix, size_t index);
+                status_t            build_blind_view();
                 void                update_rating(channel_t *ch);
+                void                update_active();
                 void                reset_ratings();
                 void                blind_test_enable();
-                void                shuffle_data();
+                void                restart_blind_test();
                 void                update_blind_grid();
                 void                select_updated(tk::Button *btn);
+                void                apply_remote_state(uint64_t state);
 
             protected:
-                static status_t     slot_rating_button_change(tk::Widget *sender, void *ptr, void *data);
+                static status_t     slot_rating_change(tk::Widget *sender, void *ptr, void *data);
                 static status_t     slot_channel_name_updated(tk::Widget *sender, void *ptr, void *data);
                 static status_t     slot_select_updated(tk::Widget *sender, void *ptr, void *data);
 
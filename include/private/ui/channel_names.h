@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PRIVATE_UI_CHANNEL_NAMES_H_
+#define PRIVATE_UI_CHANNEL_NAMES_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/common/types.h>
+
+namespace lsp
+{
+    namespace plugui
+    {
+        /**
+         * Names of all channels serialized to the single KVT blob.
+         *
+         * The blob has the 8-byte header with the magic, the version and the number of
+         * channels, followed by the record per channel: the 16-bit little-endian length
+         * of the name and its UTF-8 bytes with no terminator. The blob buffer is reused
+         * and grows only when the names get longer, so the blob is encoded and decoded in
+         * one pass with no string parsing. The empty name stands for the default name of
+         * the channel.
+         */
+        class channel_names
+        {
+            private:
+                channel_names & operator = (const channel_names &);
+                channel_names(const channel_names &);
+
+            public:
+                static constexpr size_t     MAX_CHANNELS    = 8;
+                static constexpr size_t     MAX_NAME_BYTES  = 0xffff;
+                static constexpr size_t     HEADER_BYTES    = 8;
+                static constexpr size_t     LENGTH_BYTES    = 2;
+                static constexpr uint8_t    VERSION         = 2;
+
+                static const char          *CONTENT_TYPE;
+
+            protected:
+                size_t              nCount;                             // Number of channels
+                char               *vNames[MAX_CHANNELS];               // Zero-terminated names, NULL for default
+                uint8_t            *vBlob;                              // Encoded blob
+                size_t              nBlobCap;                           // Capacity of the blob buffer
+
+            protected:
+                static char        *copy_name(const char *name, size_t len);
+
+            public:
+                explicit channel_names();
+                ~channel_names();
+
+            public:
+                /**
+                 * Reset all names to default
+                 * @param count number of channels
+                 */
+                void                clear(size_t count);
+
+                /**
+                 * Set the name of the channel, names longer than MAX_NAME_BYTES are truncated
+                 * at the character boundary
+                 * @param index index of the channel
+                 * @param name UTF-8 name, NULL or empty string for the default name
+                 * @return true if the name has changed
+                 */
+                bool                set(size_t index, const char *name);
+
+                /**
+                 * Get the name of the channel
+                 * @param index index of the channel
+                 * @return UTF-8 name, empty string for the default name
+                 */
+                const char         *get(size_t index) const;
+
+                /**
+                 * Get the number of channels
+                 * @return number of channels
+                 */
+                inline size_t       count() const       { return nCount; }
+
+                /**
+                 * Encode names to the blob, the blob remains valid until the next call
+                 * @param size pointer to store the size of the blob
+                 * @return pointer to the blob or NULL if there is not enough memory
+                 */
+                const void         *encode(size_t *size);
+
+                /**
+                 * Decode names from the blob, names are not modified on format error
+                 * @param data blob data
+                 * @param size size of the blob
+                 * @return status of operation
+                 */
+                status_t            decode(const void *data, size_t size);
+        };
+
+    } /* namespace plugui */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UI_CHANNEL_NAMES_H_ */
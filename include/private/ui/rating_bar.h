@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UI_RATING_BAR_H_
+#define PRIVATE_UI_RATING_BAR_H_
+
+#include <lsp-plug.in/tk/tk.h>
+
+namespace lsp
+{
+    namespace tk
+    {
+        // Style definition
+        namespace style
+        {
+            LSP_TK_STYLE_DEF_BEGIN(RatingBar, Widget)
+                prop::Integer       sValue;
+                prop::Integer       sLevels;
+                prop::Boolean       sActive;
+                prop::Integer       sSpacing;
+                prop::Integer       sCellWidth;
+                prop::Integer       sBorderRadius;
+                prop::Color         sColor;
+                prop::Color         sBorderColor;
+                prop::Color         sDownColor;
+                prop::Color         sDownBorderColor;
+                prop::Color         sInactiveColor;
+                prop::Color         sInactiveBorderColor;
+            LSP_TK_STYLE_DEF_END
+        } /* namespace style */
+
+        /**
+         * Rating bar: a row of levels drawn by a single widget. The value is the
+         * number of lit levels, clicking a level sets the value to its number and
+         * emits SLOT_CHANGE.
+         */
+        class RatingBar: public Widget
+        {
+            private:
+                RatingBar & operator = (const RatingBar &);
+                RatingBar(const RatingBar &);
+
+            public:
+                static const w_class_t    metadata;
+
+            protected:
+                prop::Integer       sValue;                 // Number of lit levels
+                prop::Integer       sLevels;                // Number of levels
+                prop::Boolean       sActive;                // Active state
+                prop::Integer       sSpacing;               // Spacing between levels
+                prop::Integer       sCellWidth;             // Minimum width of the level
+                prop::Integer       sBorderRadius;          // Border radius of the level
+                prop::Color         sColor;                 // Color of the level
+                prop::Color         sBorderColor;           // Border color of the level
+                prop::Color         sDownColor;             // Color of the lit level
+                prop::Color         sDownBorderColor;       // Border color of the lit level
+                prop::Color         sInactiveColor;         // Color of the level in inactive state
+                prop::Color         sInactiveBorderColor;   // Border color of the level in inactive state
+
+                size_t              nBMask;                 // Mouse button state
+
+            protected:
+                static status_t     slot_on_change(Widget *sender, void *ptr, void *data);
+
+            protected:
+                ssize_t             find_level(ssize_t x);
+
+            protected:
+                virtual void        size_request(ws::size_limit_t *r) override;
+                virtual void        property_changed(Property *prop) override;
+
+            public:
+                explicit RatingBar(Display *dpy);
+                virtual ~RatingBar() override;
+
+                virtual status_t    init() override;
+
+            public:
+                LSP_TK_PROPERTY(Integer,    value,                  &sValue)
+                LSP_TK_PROPERTY(Integer,    levels,                 &sLevels)
+                LSP_TK_PROPERTY(Boolean,    active,                 &sActive)
+                LSP_TK_PROPERTY(Integer,    spacing,                &sSpacing)
+                LSP_TK_PROPERTY(Integer,    cell_width,             &sCellWidth)
+                LSP_TK_PROPERTY(Integer,    border_radius,          &sBorderRadius)
+                LSP_TK_PROPERTY(Color,      color,                  &sColor)
+                LSP_TK_PROPERTY(Color,      border_color,           &sBorderColor)
+                LSP_TK_PROPERTY(Color,      down_color,             &sDownColor)
+                LSP_TK_PROPERTY(Color,      down_border_color,      &sDownBorderColor)
+                LSP_TK_PROPERTY(Color,      inactive_color,         &sInactiveColor)
+                LSP_TK_PROPERTY(Color,      inactive_border_color,  &sInactiveBorderColor)
+
+            public:
+                virtual void        draw(ws::ISurface *s, bool force) override;
+
+                virtual status_t    on_mouse_down(const ws::event_t *e) override;
+                virtual status_t    on_mouse_up(const ws::event_t *e) override;
+                virtual status_t    on_mouse_move(const ws::event_t *e) override;
+
+                virtual status_t    on_change();
+        };
+
+    } /* namespace tk */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UI_RATING_BAR_H_ */
@@ -20,6 +20,10 @@
 	<li>All controls that can provide necessary information about the channel become hidden.</li>
 	<li>The rating values become changed to default values.</li>
 </ul>
+<p>
+	The inputs are shuffled by the plugin itself, so the blind test and the re-shuffle work the same way
+	with the editor closed, for example when controlled by the host automation or MIDI.
+</p>
 
 <p><b>Common controls:</b></p>
 <ul>
@@ -35,12 +39,92 @@
 	<li><b>Mute</b> - mutes the output and deselects any channel as being A/B tested.</li>
 </ul>
 
+<p><b>Loop capture controls:</b></p>
+<ul>
+	<li><b>Loop</b> - the loop capture mode:</li>
+	<ul>
+		<li><b>Live</b> - inputs are passed to the output as is.</li>
+		<li><b>Capture</b> - all inputs are simultaneously recorded into the memory until the loop length is reached.</li>
+		<li><b>Replay</b> - the recorded loop is played back instead of inputs, all inputs are kept sample-aligned.</li>
+	</ul>
+	<li><b>Length</b> - the maximum length of the loop, the loop can be shortened also after the capture.
+	Loops longer than 30 seconds are stored in the temporary file instead of the memory.
+	The storage for the loop is allocated when the capture starts and is sized by the loop length.</li>
+	<li><b>Position</b> - the current capture or replay position within the loop.</li>
+	<li><b>File play</b> - plays loaded input files instead of inputs, all files are played back in sync
+	and restart from the beginning when the longest file ends.</li>
+</ul>
+
+<p><b>MIDI control:</b></p>
+<ul>
+	<li><b>MIDI</b> - the MIDI channel to listen for control messages and the type of control messages:</li>
+	<ul>
+		<li><b>Note</b> - each note-on message selects the channel or toggles the switch.</li>
+		<li><b>CC</b> - the value of the controller selects the channel or sets the state of the switch.</li>
+	</ul>
+	<li><b>Select</b> - the base note of the channel selector, the base note mutes the output, the next notes select
+	the corresponding inputs. In CC mode, the value of the controller is the number of the input to select.
+	When the blind test is active, the number is the position of the input in the shuffled list.</li>
+	<li><b>Blind test</b> - the note or CC that toggles the blind test mode.</li>
+	<li><b>Reshuffle</b> - the note or CC that re-shuffles inputs when the blind test is active.</li>
+	<? if ($m != 'm') {?>
+	<li><b>Mono</b> - the note or CC that toggles the mono switch.</li>
+	<? } ?>
+</ul>
+<p>
+	Setting the note or CC to -1 disables the corresponding control. When the notes or CCs of controls overlap,
+	the message is applied to the first matching control in the order: selector, blind test, reshuffle, mono.
+	All MIDI control messages are applied exactly at their positions within the processed block.
+	Changing the corresponding control of the plugin overrides the state set by MIDI messages.
+	Enabling the blind test by MIDI or OSC keeps the ratings, as opposed to enabling it in the editor.
+</p>
+
+<p><b>OSC control:</b></p>
+<ul>
+	<li><b>OSC</b> - enables the listener of OSC messages on the UDP port.</li>
+	<li><b>Interface</b> - the network interface to listen: only the loopback interface or all interfaces.</li>
+	<li><b>Port</b> - the number of the UDP port to listen.</li>
+</ul>
+<p>
+	The following OSC messages with integer or floating-point arguments are accepted:
+</p>
+<ul>
+	<li><b>/ab_tester/sel &lt;index&gt;</b> - selects the input, zero index mutes the output.</li>
+	<li><b>/ab_tester/rate &lt;index&gt; &lt;rating&gt;</b> - sets the rating of the input.</li>
+</ul>
+<p>
+	When the blind test is active, the index is the position of the input in the shuffled list.
+	All received messages are applied at the beginning of the next processed block.
+	The rating set by OSC message is written to the trial journal and to the rating control of the opened editor,
+	so it is saved with the session only when the editor is open.
+</p>
+<p><b>DSP load:</b></p>
+<ul>
+	<li><b>DSP load</b> - the average and the peak time spent by the plugin in processing over the last half of a second,
+	in percents of the real-time budget of the processed audio.</li>
+	<li><b>Inputs</b> - the number of used inputs, available for variants with 4 and 8 inputs. Only the used inputs
+	are processed and participate in the blind test, other inputs are hidden and do not pass the signal to the output.</li>
+</ul>
+
+<p><b>Trial journal controls:</b></p>
+<ul>
+	<li><b>Journal</b> - enables the journal of blind test trials. Each selector switch, blind test toggle,
+	rating change and shuffle permutation is appended to the journal file as CSV line with the position in samples.</li>
+	<li><b>Save</b> - allows to select the journal file.</li>
+</ul>
+
 <p><b>Individual input controls:</b></p>
 <ul>
 	<li><b>User label</b> - custom user text to identify the input.</li>
 	<li><b>Link</b> - allows to add additional signal from shared memory link to the input channel's signal.</li>
+	<li><b>Load</b> - allows to load the audio file that is played instead of the input when the file playback is enabled.
+	The file is kept in the memory, so only the first 60 seconds of the file are loaded.</li>
 	<li><b>In test</b> - allows to mark the input as selected for blind test.</li>
 	<li><b>Rating</b> - the user rating that can be assigned to the corresponding input.</li>
 	<li><b>Gain</b> - the makeup gain for the corresponding input.</li>
 	<li><b>Active</b> - the button that activates corresponding input.</li>
 </ul>
+<p>
+	Hosts that support inline display show the peak level of each input and highlight the selected input.
+	In the blind test mode the selection is not highlighted and the background of the display is dimmed.
+</p>
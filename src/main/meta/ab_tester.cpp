@@ -27,7 +27,7 @@
 
 #define LSP_PLUGINS_AB_TESTER_VERSION_MAJOR       1
 #define LSP_PLUGINS_AB_TESTER_VERSION_MINOR       0
-#define LSP_PLUGINS_AB_TESTER_VERSION_MICRO       25
+#define LSP_PLUGINS_AB_TESTER_VERSION_MICRO       26
 
 #define LSP_PLUGINS_AB_TESTER_VERSION  \
     LSP_MODULE_VERSION( \
@@ -51,6 +51,7 @@ namespace lsp
         #define ABTEST_MONO_CHANNEL(id, label, alias, blind_switch, bte) \
             AUDIO_INPUT("in" id, "Audio input " label), \
             OPT_RETURN_MONO("ret" id, "rin" id, "Audio return " label), \
+            PATH("ifn" id, "Input file " label), \
             AMP_GAIN100("g" id, "Input gain " label, "In gain" alias, 1.0), \
             METER_GAIN("ism" id, "Input signal meter " label, GAIN_AMP_P_48_DB), \
             blind_switch(id, label, alias, bte) \
@@ -60,6 +61,7 @@ namespace lsp
             AUDIO_INPUT("in" id "l", "Audio input " label " Left"), \
             AUDIO_INPUT("in" id "r", "Audio input " label " Right"), \
             OPT_RETURN_STEREO("ret" id, "rin" id, "Audio return " label), \
+            PATH("ifn" id, "Input file " label), \
             AMP_GAIN100("g" id, "Input gain " label, "In gain" alias, 1.0), \
             METER_GAIN("ism" id "l", "Input signal meter " label " Left", GAIN_AMP_P_48_DB), \
             METER_GAIN("ism" id "r", "Input signal meter " label " Right", GAIN_AMP_P_48_DB), \
@@ -75,10 +77,95 @@ namespace lsp
         #define ABTEST_MONO_SWITCH \
             SWITCH("mono", "Mono switch", "Mono", 0.0f)
 
+        #define ABTEST_LOOP \
+            COMBO("lmode", "Loop capture mode", "Loop mode", meta::ab_tester::LOOP_LIVE, ab_tester_loop_modes), \
+            LOG_CONTROL("llen", "Loop length", "Loop len", U_SEC, meta::ab_tester::LOOP_LEN), \
+            METER("lpos", "Loop position", U_SEC, meta::ab_tester::LOOP_LEN), \
+            SWITCH("fply", "Input file playback", "File play", 0.0f), \
+            SWITCH("jon", "Trial journal enable", "Journal", 0.0f), \
+            PATH("jfn", "Trial journal file")
+
+        #define ABTEST_MIDI \
+            MIDI_INPUT(LSP_LV2_MIDI_PORT_IN, "MIDI input"), \
+            COMBO("mch", "MIDI control channel", "MIDI chan", 0, ab_tester_midi_channels), \
+            COMBO("mtype", "MIDI control message type", "MIDI type", meta::ab_tester::MIDI_NOTE, ab_tester_midi_types), \
+            INT_CONTROL_ALL("msel", "MIDI channel selector note or CC", "MIDI sel", U_NONE, \
+                meta::ab_tester::MIDI_NUM_MIN, meta::ab_tester::MIDI_NUM_MAX, meta::ab_tester::MIDI_SEL_DFL, meta::ab_tester::MIDI_NUM_STEP), \
+            INT_CONTROL_ALL("mbte", "MIDI blind test note or CC", "MIDI blind", U_NONE, \
+                meta::ab_tester::MIDI_NUM_MIN, meta::ab_tester::MIDI_NUM_MAX, meta::ab_tester::MIDI_BLIND_DFL, meta::ab_tester::MIDI_NUM_STEP), \
+            INT_CONTROL_ALL("mshuf", "MIDI re-shuffle note or CC", "MIDI shuf", U_NONE, \
+                meta::ab_tester::MIDI_NUM_MIN, meta::ab_tester::MIDI_NUM_MAX, meta::ab_tester::MIDI_SHUFFLE_DFL, meta::ab_tester::MIDI_NUM_STEP)
+
+        #define ABTEST_MIDI_MONO \
+            INT_CONTROL_ALL("mmono", "MIDI mono switch note or CC", "MIDI mono", U_NONE, \
+                meta::ab_tester::MIDI_NUM_MIN, meta::ab_tester::MIDI_NUM_MAX, meta::ab_tester::MIDI_MONO_DFL, meta::ab_tester::MIDI_NUM_STEP)
+
+        #define ABTEST_OSC \
+            SWITCH("osc", "OSC listener enable", "OSC", 0.0f), \
+            COMBO("osca", "OSC listener interface", "OSC iface", meta::ab_tester::OSC_LOOPBACK, ab_tester_osc_interfaces), \
+            INT_CONTROL_ALL("oscp", "OSC listener port", "OSC port", U_NONE, \
+                meta::ab_tester::OSC_PORT_MIN, meta::ab_tester::OSC_PORT_MAX, meta::ab_tester::OSC_PORT_DFL, meta::ab_tester::OSC_PORT_STEP)
+
+        #define ABTEST_TIMING \
+            METER("dload", "DSP load", U_PERCENT, meta::ab_tester::DSP_LOAD), \
+            METER("dpeak", "DSP peak load", U_PERCENT, meta::ab_tester::DSP_LOAD)
+
+        #define ABTEST_INPUTS(n) \
+            INT_CONTROL_ALL("inputs", "Number of used inputs", "Inputs", U_NONE, \
+                meta::ab_tester::INPUTS_MIN, n, n, meta::ab_tester::INPUTS_STEP)
+
+        static const port_item_t ab_tester_osc_interfaces[] =
+        {
+            { "Loopback",   "ab_tester.osc.loopback"    },
+            { "All",        "ab_tester.osc.all"         },
+            { NULL,         NULL                        }
+        };
+
+        static const port_item_t ab_tester_midi_channels[] =
+        {
+            { "Omni",       "ab_tester.midi.omni"       },
+            { "1",          NULL                        },
+            { "2",          NULL                        },
+            { "3",          NULL                        },
+            { "4",          NULL                        },
+            { "5",          NULL                        },
+            { "6",          NULL                        },
+            { "7",          NULL                        },
+            { "8",          NULL                        },
+            { "9",          NULL                        },
+            { "10",         NULL                        },
+            { "11",         NULL                        },
+            { "12",         NULL                        },
+            { "13",         NULL                        },
+            { "14",         NULL                        },
+            { "15",         NULL                        },
+            { "16",         NULL                        },
+            { NULL,         NULL                        }
+        };
+
+        static const port_item_t ab_tester_midi_types[] =
+        {
+            { "Note",       "ab_tester.midi.note"       },
+            { "CC",         "ab_tester.midi.cc"         },
+            { NULL,         NULL                        }
+        };
+
+        static const port_item_t ab_tester_loop_modes[] =
+        {
+            { "Live",       "ab_tester.loop.live"       },
+            { "Capture",    "ab_tester.loop.capture"    },
+            { "Replay",     "ab_tester.loop.replay"     },
+            { NULL,         NULL                        }
+        };
+
         static const port_t ab_tester_x2_mono_ports[] =
         {
             AUDIO_OUTPUT_MONO,
             ABTEST_GLOBAL(3),
+            ABTEST_LOOP,
+            ABTEST_MIDI,
+            ABTEST_OSC,
+            ABTEST_TIMING,
             ABTEST_MONO_CHANNEL("_1", "1", " 1", NO_BLIND_SWITCH, 1.0),
             ABTEST_MONO_CHANNEL("_2", "2", " 2", NO_BLIND_SWITCH, 1.0),
             PORTS_END
@@ -88,6 +175,11 @@ namespace lsp
         {
             AUDIO_OUTPUT_MONO,
             ABTEST_GLOBAL(5),
+            ABTEST_LOOP,
+            ABTEST_MIDI,
+            ABTEST_OSC,
+            ABTEST_TIMING,
+            ABTEST_INPUTS(4),
             ABTEST_MONO_CHANNEL("_1", "1", " 1", BLIND_SWITCH, 1.0),
             ABTEST_MONO_CHANNEL("_2", "2", " 2", BLIND_SWITCH, 1.0),
             ABTEST_MONO_CHANNEL("_3", "3", " 3", BLIND_SWITCH, 0.0),
@@ -99,6 +191,11 @@ namespace lsp
         {
             AUDIO_OUTPUT_MONO,
             ABTEST_GLOBAL(9),
+            ABTEST_LOOP,
+            ABTEST_MIDI,
+            ABTEST_OSC,
+            ABTEST_TIMING,
+            ABTEST_INPUTS(8),
             ABTEST_MONO_CHANNEL("_1", "1", " 1", BLIND_SWITCH, 1.0),
             ABTEST_MONO_CHANNEL("_2", "2", " 2", BLIND_SWITCH, 1.0),
             ABTEST_MONO_CHANNEL("_3", "3", " 3", BLIND_SWITCH, 0.0),
@@ -115,6 +212,11 @@ namespace lsp
             AUDIO_OUTPUT_STEREO,
             ABTEST_GLOBAL(3),
             ABTEST_MONO_SWITCH,
+            ABTEST_LOOP,
+            ABTEST_MIDI,
+            ABTEST_MIDI_MONO,
+            ABTEST_OSC,
+            ABTEST_TIMING,
             ABTEST_STEREO_CHANNEL("_1", "1", " 1", NO_BLIND_SWITCH, 1.0),
             ABTEST_STEREO_CHANNEL("_2", "2", " 2", NO_BLIND_SWITCH, 1.0),
             PORTS_END
@@ -125,6 +227,12 @@ namespace lsp
             AUDIO_OUTPUT_STEREO,
             ABTEST_GLOBAL(5),
             ABTEST_MONO_SWITCH,
+            ABTEST_LOOP,
+            ABTEST_MIDI,
+            ABTEST_MIDI_MONO,
+            ABTEST_OSC,
+            ABTEST_TIMING,
+            ABTEST_INPUTS(4),
             ABTEST_STEREO_CHANNEL("_1", "1", " 1", BLIND_SWITCH, 1.0),
             ABTEST_STEREO_CHANNEL("_2", "2", " 2", BLIND_SWITCH, 1.0),
             ABTEST_STEREO_CHANNEL("_3", "3", " 3", BLIND_SWITCH, 0.0),
@@ -137,6 +245,12 @@ namespace lsp
             AUDIO_OUTPUT_STEREO,
             ABTEST_GLOBAL(9),
             ABTEST_MONO_SWITCH,
+            ABTEST_LOOP,
+            ABTEST_MIDI,
+            ABTEST_MIDI_MONO,
+            ABTEST_OSC,
+            ABTEST_TIMING,
+            ABTEST_INPUTS(8),
             ABTEST_STEREO_CHANNEL("_1", "1", " 1", BLIND_SWITCH, 1.0),
             ABTEST_STEREO_CHANNEL("_2", "2", " 2", BLIND_SWITCH, 1.0),
             ABTEST_STEREO_CHANNEL("_3", "3", " 3", BLIND_SWITCH, 0.0),
@@ -266,7 +380,7 @@ namespace lsp
             LSP_PLUGINS_AB_TESTER_VERSION,
             plugin_classes,
             clap_features_mono,
-            E_DUMP_STATE | E_KVT_SYNC,
+            E_DUMP_STATE | E_KVT_SYNC | E_INLINE_DISPLAY,
             ab_tester_x2_mono_ports,
             "plugins/util/ab_tester.xml",
             NULL,
@@ -298,7 +412,7 @@ namespace lsp
             LSP_PLUGINS_AB_TESTER_VERSION,
             plugin_classes,
             clap_features_mono,
-            E_DUMP_STATE | E_KVT_SYNC,
+            E_DUMP_STATE | E_KVT_SYNC | E_INLINE_DISPLAY,
             ab_tester_x4_mono_ports,
             "plugins/util/ab_tester.xml",
             NULL,
@@ -330,7 +444,7 @@ namespace lsp
             LSP_PLUGINS_AB_TESTER_VERSION,
             plugin_classes,
             clap_features_mono,
-            E_DUMP_STATE | E_KVT_SYNC,
+            E_DUMP_STATE | E_KVT_SYNC | E_INLINE_DISPLAY,
             ab_tester_x8_mono_ports,
             "plugins/util/ab_tester.xml",
             NULL,
@@ -362,7 +476,7 @@ namespace lsp
             LSP_PLUGINS_AB_TESTER_VERSION,
             plugin_classes,
             clap_features_stereo,
-            E_DUMP_STATE | E_KVT_SYNC,
+            E_DUMP_STATE | E_KVT_SYNC | E_INLINE_DISPLAY,
             ab_tester_x2_stereo_ports,
             "plugins/util/ab_tester.xml",
             NULL,
@@ -394,7 +508,7 @@ namespace lsp
             LSP_PLUGINS_AB_TESTER_VERSION,
             plugin_classes,
             clap_features_stereo,
-            E_DUMP_STATE | E_KVT_SYNC,
+            E_DUMP_STATE | E_KVT_SYNC | E_INLINE_DISPLAY,
             ab_tester_x4_stereo_ports,
             "plugins/util/ab_tester.xml",
             NULL,
@@ -426,7 +540,7 @@ namespace lsp
             LSP_PLUGINS_AB_TESTER_VERSION,
             plugin_classes,
             clap_features_stereo,
-            E_DUMP_STATE | E_KVT_SYNC,
+            E_DUMP_STATE | E_KVT_SYNC | E_INLINE_DISPLAY,
             ab_tester_x8_stereo_ports,
             "plugins/util/ab_tester.xml",
             NULL,
@@ -23,19 +23,76 @@
 #include <lsp-plug.in/common/debug.h>
 #include <lsp-plug.in/dsp/dsp.h>
 #include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/ipc/Thread.h>
 #include <lsp-plug.in/plug-fw/core/AudioBuffer.h>
+#include <lsp-plug.in/plug-fw/core/KVTStorage.h>
 #include <lsp-plug.in/plug-fw/meta/func.h>
+#include <lsp-plug.in/protocol/midi.h>
+#include <lsp-plug.in/runtime/system.h>
 #include <lsp-plug.in/shared/debug.h>
+#include <lsp-plug.in/shared/id_colors.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/stdlib/string.h>
 
 #include <private/plugins/ab_tester.h>
+#include <private/shared/tracer.h>
 
 namespace lsp
 {
+    /* The size of the trial journal queue in records */
+    static constexpr size_t JOURNAL_SIZE        = 0x400U;
+    /* The size of the OSC command queue */
+    static constexpr size_t OSC_QUEUE_SIZE      = 0x100U;
+    /* The period of polling the shuffle state for the journal */
+    static constexpr float  JOURNAL_POLL_PERIOD = 0.1f;
+
     /* The size of temporary buffer for audio processing */
     static constexpr size_t BUFFER_SIZE         = 0x400U;
+    /* The maximum length of the loop stored in memory, longer loops are spilled to disk */
+    static constexpr float  LOOP_RAM_LEN        = 30.0f;
+    /* The length of the staging buffer for the spilled loop */
+    static constexpr float  SPILL_RING_LEN      = 1.0f;
+    /* The amount of spilled loop data kept resident ahead of the replay position */
+    static constexpr float  SPILL_PREFETCH_LEN  = 2.0f;
+    /* The lowest level shown by the inline display, dB */
+    static constexpr float  DISPLAY_DB_MIN      = -48.0f;
+    /* The level step of the inline display, dB */
+    static constexpr float  DISPLAY_DB_STEP     = 1.5f;
+    /* The number of level steps of the inline display */
+    static constexpr size_t DISPLAY_STEPS       = 32;
 
     namespace plugins
     {
+        static const char *KVT_SHUFFLE_INDICES  = "/shuffle_indices";
+        static const char *KVT_REMOTE_STATE     = "/remote_state";
+
+        //---------------------------------------------------------------------
+        // Strided data access for the interleaved processing
+        static void gather(float *dst, const float *src, size_t stride, size_t count)
+        {
+            if (stride == 1)
+            {
+                dsp::copy(dst, src, count);
+                return;
+            }
+
+            for (size_t i=0; i<count; ++i, src += stride)
+                dst[i]      = *src;
+        }
+
+        static void scatter_add(float *dst, const float *src, size_t stride, size_t count)
+        {
+            if (stride == 1)
+            {
+                dsp::add2(dst, src, count);
+                return;
+            }
+
+            for (size_t i=0; i<count; ++i, dst += stride)
+                *dst       += src[i];
+        }
+
         //---------------------------------------------------------------------
         // Plugin factory
         static const meta::plugin_t *plugins[] =
@@ -55,26 +112,127 @@ namespace lsp
 
         static plug::Factory factory(plugin_factory, plugins, 6);
 
+        //---------------------------------------------------------------------
+        // File loader
+        ab_tester::FileLoader::FileLoader(ab_tester *core, afile_t *file)
+        {
+            pCore       = core;
+            pFile       = file;
+        }
+
+        ab_tester::FileLoader::~FileLoader()
+        {
+            pCore       = NULL;
+            pFile       = NULL;
+        }
+
+        status_t ab_tester::FileLoader::run()
+        {
+            return pCore->load_file(pFile);
+        }
+
+        //---------------------------------------------------------------------
+        // Loop capture arena allocator
+        ab_tester::LoopAllocator::LoopAllocator(ab_tester *core)
+        {
+            pCore       = core;
+        }
+
+        ab_tester::LoopAllocator::~LoopAllocator()
+        {
+            pCore       = NULL;
+        }
+
+        status_t ab_tester::LoopAllocator::run()
+        {
+            return pCore->allocate_loop();
+        }
+
         //---------------------------------------------------------------------
         // Implementation
         ab_tester::ab_tester(const meta::plugin_t *meta):
-            Module(meta)
+            Module(meta),
+            sLoopAlloc(this)
         {
             vInChannels     = NULL;
             vOutChannels    = NULL;
+            vFiles          = NULL;
             nInChannels     = 0;
             nOutChannels    = 0;
+            nFiles          = 0;
+            nInStride       = 1;
+            nOutStride      = 1;
             vTmp            = NULL;
+            pExecutor       = NULL;
 
             bBlindTest      = false;
             bMono           = false;
             nSelector       = 0;
+            nLoopMode       = meta::ab_tester::LOOP_LIVE;
+            nLoopCap        = 0;
+            nLoopRamMax     = 0;
+            nLoopRequest    = 0;
+            bLoopArmed      = false;
+            nLoopLength     = 0;
+            nLoopSize       = 0;
+            nLoopPos        = 0;
+            nLoopLimit      = 0;
+            bLoopSpill      = false;
+            bFilePlay       = false;
+            nFilePos        = 0;
+            nFileLength     = 0;
+            bJournal        = false;
+            nShuffle        = 0;
+            nShufflePoll    = 0;
+            nClock          = 0;
+            nMidiChannel    = 0;
+            nMidiType       = meta::ab_tester::MIDI_NOTE;
+            nMidiSel        = -1;
+            nMidiBlind      = -1;
+            nMidiShuffle    = -1;
+            nMidiMono       = -1;
+            nRandom         = 0x1234567;
+            fPortSel        = -1.0f;
+            fPortBlind      = -1.0f;
+            nBlindSet       = 0;
+            fPortMono       = -1.0f;
+            fPortShuffle    = -1.0f;
+            bShufflePub     = false;
+            nRemotePub      = 0;
+            nLoadShuffle    = 0;
+            atomic_store(&nStateLoaded, 0);
+            nStateReadTime  = 0;
+            nActive         = 0;
+            nDispSelector   = 0;
+            bDispBlind      = false;
 
             pBlindTest      = NULL;
             pMono           = NULL;
+            pShuffle        = NULL;
             pChannelSel     = NULL;
+            pLoopMode       = NULL;
+            pLoopLength     = NULL;
+            pLoopPos        = NULL;
+            pFilePlay       = NULL;
+            pJournal        = NULL;
+            pJournalFile    = NULL;
+            pMidiIn         = NULL;
+            pMidiChannel    = NULL;
+            pMidiType       = NULL;
+            pMidiSel        = NULL;
+            pMidiBlind      = NULL;
+            pMidiShuffle    = NULL;
+            pMidiMono       = NULL;
+            pOscOn          = NULL;
+            pOscIface       = NULL;
+            pOscPort        = NULL;
+            pDspLoad        = NULL;
+            pDspPeak        = NULL;
+            pInputs         = NULL;
 
             pData           = NULL;
+            nDataSize       = 0;
+            pLoopData       = NULL;
 
             for (const meta::port_t *port = meta->ports; ((port != NULL) && (port->id != NULL)); ++port)
             {
@@ -83,6 +241,8 @@ namespace lsp
                 else if (meta::is_audio_out_port(port))
                     ++nOutChannels;
             }
+            nFiles          = (nOutChannels > 0) ? nInChannels / nOutChannels : 0;
+            nActive         = nInChannels;
         }
 
         ab_tester::~ab_tester()
@@ -94,37 +254,83 @@ namespace lsp
         {
             // Call parent class for initialization
             Module::init(wrapper, ports);
+        #ifdef LSP_AB_TESTER_TRACE
+            tracer::attach();
+        #endif /* LSP_AB_TESTER_TRACE */
+            pExecutor                   = wrapper->executor();
+
+            // Seed the shuffle generator, each instance and each session get own permutations
+            system::time_t ts;
+            system::get_time(&ts);
+            nRandom                     = uint32_t(ts.seconds) ^ (uint32_t(ts.nanos) << 7) ^
+                                          uint32_t(uintptr_t(this) >> 4) ^ uint32_t(uint64_t(uintptr_t(this)) >> 32);
+            if (nRandom == 0)
+                nRandom                     = 0x1234567;    // Xorshift never leaves the zero state
+
+            if (sJournal.init(JOURNAL_SIZE) != STATUS_OK)
+                return;
+            if (sOsc.init(OSC_QUEUE_SIZE) != STATUS_OK)
+                return;
 
             // Estimate allocation size
             size_t szof_in_channel      = align_size(sizeof(in_channel_t) * nInChannels, DEFAULT_ALIGN);
             size_t szof_out_channel     = align_size(sizeof(out_channel_t) * nOutChannels, DEFAULT_ALIGN);
+            size_t szof_files           = align_size(sizeof(afile_t) * nFiles, DEFAULT_ALIGN);
             size_t szof_buffers         = BUFFER_SIZE * sizeof(float);
-            size_t alloc                = szof_in_channel + szof_out_channel + szof_buffers;
+            size_t alloc                = szof_in_channel + szof_out_channel + szof_files + szof_buffers;
 
             // Allocate data
             uint8_t *ptr                = alloc_aligned<uint8_t>(pData, alloc, DEFAULT_ALIGN);
             if (ptr == NULL)
                 return;
+            nDataSize                   = alloc;
 
             // Input channels
             vInChannels                 = advance_ptr_bytes<in_channel_t>(ptr, szof_in_channel);
             vOutChannels                = advance_ptr_bytes<out_channel_t>(ptr, szof_out_channel);
+            vFiles                      = advance_ptr_bytes<afile_t>(ptr, szof_files);
             vTmp                        = advance_ptr_bytes<float>(ptr, szof_buffers);
 
+            // Initialize input files
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                afile_t *af         = &vFiles[i];
+
+                af->pLoader         = new FileLoader(this, af);
+                af->pSample         = NULL;
+                af->pLoaded         = NULL;
+                af->bReload         = false;
+
+                af->pFile           = NULL;
+            }
+
             // Initialize input channels
             for (size_t i=0; i<nInChannels; ++i)
             {
                 in_channel_t *c     = &vInChannels[i];
 
                 c->sBypass.construct();
+                c->sGain.construct();
                 c->vIn              = NULL;
+                c->vRet             = NULL;
+                c->vLoop            = NULL;
+                c->pFile            = &vFiles[i / nOutChannels];
 
-                c->fOldGain         = GAIN_AMP_0_DB;
-                c->fGain            = GAIN_AMP_0_DB;
+                c->nRating          = 0;
+                c->fPortRating      = -1.0f;
+                c->vSrc             = NULL;
+                c->vSrcRet          = NULL;
+                c->vCapture         = NULL;
+                c->nSrcStride       = 1;
+                c->fLevel           = 0.0f;
+                c->nDispLevel       = 0;
 
                 c->pIn              = NULL;
+                c->pRet             = NULL;
                 c->pGain            = NULL;
                 c->pInMeter         = NULL;
+                c->pRating          = NULL;
+                c->pBlindSel        = NULL;
             }
 
             // Initialize output channels
@@ -147,13 +353,34 @@ namespace lsp
             // Bind global ports
             SKIP_PORT("Reset rating");
             BIND_PORT(pBlindTest); // Blind test enable
-            SKIP_PORT("Re-shuffle");
+            BIND_PORT(pShuffle);
             BIND_PORT(pChannelSel); // Channel selector
             if (nOutChannels > 1)
                 BIND_PORT(pMono);
+            BIND_PORT(pLoopMode);
+            BIND_PORT(pLoopLength);
+            BIND_PORT(pLoopPos);
+            BIND_PORT(pFilePlay);
+            BIND_PORT(pJournal);
+            BIND_PORT(pJournalFile);
+            BIND_PORT(pMidiIn);
+            BIND_PORT(pMidiChannel);
+            BIND_PORT(pMidiType);
+            BIND_PORT(pMidiSel);
+            BIND_PORT(pMidiBlind);
+            BIND_PORT(pMidiShuffle);
+            if (nOutChannels > 1)
+                BIND_PORT(pMidiMono);
+            BIND_PORT(pOscOn);
+            BIND_PORT(pOscIface);
+            BIND_PORT(pOscPort);
+            BIND_PORT(pDspLoad);
+            BIND_PORT(pDspPeak);
 
             // Input ports
             size_t num_inputs   = nInChannels / nOutChannels;
+            if (num_inputs > 2)
+                BIND_PORT(pInputs);
             for (size_t i=0; i<nInChannels; i += nOutChannels)
             {
                 if (nOutChannels == 1)
@@ -162,6 +389,7 @@ namespace lsp
                     BIND_PORT(c->pIn);
                     SKIP_PORT("Return name");
                     BIND_PORT(c->pRet);
+                    BIND_PORT(c->pFile->pFile);
                     BIND_PORT(c->pGain);
                     BIND_PORT(c->pInMeter);
                 }
@@ -174,6 +402,7 @@ namespace lsp
                     SKIP_PORT("Return name");
                     BIND_PORT(l->pRet);
                     BIND_PORT(r->pRet);
+                    BIND_PORT(l->pFile->pFile);
                     BIND_PORT(l->pGain);
                     BIND_PORT(l->pInMeter);
                     BIND_PORT(r->pInMeter);
@@ -181,11 +410,10 @@ namespace lsp
                     r->pGain            = l->pGain;
                 }
 
-                // Skip blind test input switch
+                // Blind test input switch
                 if (num_inputs > 2)
-                    SKIP_PORT("Blind test input switch");
-                // Skip rating value
-                SKIP_PORT("Input rating");
+                    BIND_PORT(vInChannels[i].pBlindSel);
+                BIND_PORT(vInChannels[i].pRating);
             }
         }
 
@@ -193,47 +421,857 @@ namespace lsp
         {
             Module::destroy();
             do_destroy();
+
+        #ifdef LSP_AB_TESTER_TRACE
+            tracer::detach("");
+        #endif /* LSP_AB_TESTER_TRACE */
+        }
+
+        void ab_tester::destroy_sample(dspu::Sample * &sample)
+        {
+            if (sample == NULL)
+                return;
+
+            sample->destroy();
+            delete sample;
+            sample      = NULL;
         }
 
         void ab_tester::do_destroy()
         {
+            while ((!sLoopAlloc.idle()) && (!sLoopAlloc.completed()))
+                ipc::Thread::sleep(10);
+            if (sLoopAlloc.completed())
+                sLoopAlloc.reset();
+
+            sSpill.destroy();
+            sJournal.destroy();
+            sOsc.destroy();
+
+            // Destroy input files
+            if (vFiles != NULL)
+            {
+                for (size_t i=0; i<nFiles; ++i)
+                {
+                    afile_t *af         = &vFiles[i];
+                    if (af->pLoader != NULL)
+                    {
+                        while ((!af->pLoader->idle()) && (!af->pLoader->completed()))
+                            ipc::Thread::sleep(10);
+                        delete af->pLoader;
+                        af->pLoader         = NULL;
+                    }
+
+                    destroy_sample(af->pSample);
+                    destroy_sample(af->pLoaded);
+                }
+                vFiles          = NULL;
+            }
+
+            free_loop();
             if (pData != NULL)
             {
                 free_aligned(pData);
                 pData       = NULL;
             }
+            vInChannels = NULL;
+            vOutChannels= NULL;
+            vTmp        = NULL;
+            nDataSize   = 0;
+        }
+
+        void ab_tester::free_loop()
+        {
+            if (pLoopData != NULL)
+            {
+                free_aligned(pLoopData);
+                pLoopData   = NULL;
+            }
+
+            nLoopCap        = 0;
+            if (vInChannels != NULL)
+            {
+                for (size_t i=0; i<nInChannels; ++i)
+                    vInChannels[i].vLoop    = NULL;
+            }
         }
 
         void ab_tester::update_sample_rate(long sr)
         {
+            sTimer.set_sample_rate(sr);
+
             for (size_t i=0; i<nInChannels; ++i)
             {
                 in_channel_t *c     = &vInChannels[i];
                 c->sBypass.init(sr);
+                c->sGain.set_sample_rate(sr);
             }
+
+            // Loaded files should be resampled to the new sample rate
+            for (size_t i=0; i<nFiles; ++i)
+                vFiles[i].bReload   = true;
+
+            // Captured data does not match the new sample rate anymore
+            nLoopSize           = 0;
+            nLoopPos            = 0;
+            nLoopLimit          = 0;
+            bLoopSpill          = false;
+            bLoopArmed          = nLoopMode == meta::ab_tester::LOOP_CAPTURE;
+
+            // The loop capture arena and the on-disk storage are allocated on demand
+            while ((!sLoopAlloc.idle()) && (!sLoopAlloc.completed()))
+                ipc::Thread::sleep(10);
+            if (sLoopAlloc.completed())
+                sLoopAlloc.reset();
+
+            sSpill.destroy();
+            free_loop();
+            nLoopRamMax         = dspu::seconds_to_samples(sr, LOOP_RAM_LEN);
         }
 
         void ab_tester::update_settings()
         {
-            bBlindTest      = pBlindTest->value() >= 0.5f;
-            bMono           = (pMono != NULL) ? pMono->value() >= 0.5f : false;
-            nSelector       = lsp_max(0.0f, pChannelSel->value());
+            AB_TRACE_SCOPE("update_settings");
 
-            lsp_trace("selector = %d", int(nSelector));
+            bool journal    = pJournal->value() >= 0.5f;
+            bool start      = (journal) && (!bJournal);
+
+            // Write changes to the journal only if it has already been started
+            bJournal        = (journal) && (bJournal);
+
+            // MIDI control mapping, the value of -1 disables the control
+            const size_t midi_type      = pMidiType->value();
+            const ssize_t midi_sel      = pMidiSel->value();
+            const ssize_t midi_blind    = pMidiBlind->value();
+            const ssize_t midi_shuffle  = pMidiShuffle->value();
+            const ssize_t midi_mono     = (pMidiMono != NULL) ? ssize_t(pMidiMono->value()) : -1;
+            const bool midi_changed     = (midi_type != nMidiType) || (midi_sel != nMidiSel) ||
+                                          (midi_blind != nMidiBlind) || (midi_shuffle != nMidiShuffle) ||
+                                          (midi_mono != nMidiMono);
+            nMidiChannel    = pMidiChannel->value();
+            nMidiType       = midi_type;
+            nMidiSel        = midi_sel;
+            nMidiBlind      = midi_blind;
+            nMidiShuffle    = midi_shuffle;
+            nMidiMono       = midi_mono;
+            if ((midi_changed) && (midi_overlap()))
+                lsp_warn("MIDI controls overlap, they are matched in the order: selector, blind test, re-shuffle, mono");
+
+            // Only the used inputs are processed, meters of unused inputs are cleared
+            const size_t candidates = nInChannels / nOutChannels;
+            size_t used     = (pInputs != NULL) ? size_t(lsp_max(0.0f, pInputs->value())) : candidates;
+            used            = (used < meta::ab_tester::INPUTS_MIN) ? meta::ab_tester::INPUTS_MIN : used;
+            used            = (used > candidates) ? candidates : used;
+            if (used * nOutChannels != nActive)
+            {
+                nActive         = used * nOutChannels;
+                for (size_t i=nActive; i<nInChannels; ++i)
+                {
+                    in_channel_t *c     = &vInChannels[i];
+                    c->fLevel           = 0.0f;
+                    c->pInMeter->set_value(0.0f);
+                }
+                lsp_trace("active input channels = %d", int(nActive));
+            }
+
+            // Apply switches only if they have been changed, the state may be changed by MIDI events.
+            // The blind test switch is also applied again when the set of inputs taking part in it changes
+            uint32_t items[8];
+            uint32_t blind_set  = 0;
+            for (size_t i=0, n=blind_inputs(items); i<n; ++i)
+                blind_set          |= 1 << (items[i] & 0x7);
+            float value     = pBlindTest->value();
+            if ((value != fPortBlind) || (blind_set != nBlindSet))
+            {
+                const bool reshuffle    = (bBlindTest) && (blind_set != nBlindSet);
+                fPortBlind      = value;
+                nBlindSet       = blind_set;
+                set_blind_test(value >= 0.5f, 0);
+
+                // The permutation should contain only the inputs taking part in the blind test
+                if ((reshuffle) && (bBlindTest) && (!shuffle(0)))
+                    set_blind_test(false, 0);
+            }
+            value           = pShuffle->value();
+            if (value != fPortShuffle)
+            {
+                fPortShuffle    = value;
+                if ((value >= 0.5f) && (bBlindTest))
+                    shuffle(0);
+            }
+            size_t selector = nSelector;
+            value           = pChannelSel->value();
+            if (value != fPortSel)
+            {
+                fPortSel        = value;
+                selector        = lsp_max(0.0f, value);
+            }
+            set_selector(selector, 0);
+            value           = (pMono != NULL) ? pMono->value() : 0.0f;
+            if (value != fPortMono)
+            {
+                fPortMono       = value;
+                bMono           = value >= 0.5f;
+            }
+
+            sOsc.configure(
+                pOscOn->value() >= 0.5f,
+                size_t(pOscIface->value()) == meta::ab_tester::OSC_ANY,
+                pOscPort->value());
+
+            nLoopLength     = dspu::seconds_to_samples(fSampleRate, pLoopLength->value());
+
+            // Start file playback from the beginning
+            bool file_play  = pFilePlay->value() >= 0.5f;
+            if ((file_play) && (!bFilePlay))
+                nFilePos        = 0;
+            bFilePlay       = file_play;
+
+            // Update loop capture mode
+            size_t loop_mode    = pLoopMode->value();
+            if (loop_mode != nLoopMode)
+            {
+                // Entering the capture mode always starts a new loop when the storage for it is ready
+                if (loop_mode == meta::ab_tester::LOOP_CAPTURE)
+                {
+                    nLoopSize           = 0;
+                    nLoopLimit          = 0;
+                    bLoopSpill          = false;
+                }
+                bLoopArmed          = loop_mode == meta::ab_tester::LOOP_CAPTURE;
+                nLoopPos            = 0;
+                nLoopMode           = loop_mode;
+            }
 
             for (size_t i=0; i<nInChannels; ++i)
             {
                 in_channel_t *c     = &vInChannels[i];
-                c->fOldGain         = c->fGain;
-                c->fGain            = c->pGain->value();
+                c->sGain.set(c->pGain->value());
                 size_t chan_id      = (i / nOutChannels) + 1;
 
-                c->sBypass.set_bypass(nSelector != chan_id);
+                // Rating is bound to the first channel of each input, it also may be changed by OSC commands
+                if (c->pRating != NULL)
+                {
+                    float value         = c->pRating->value();
+                    if (value != c->fPortRating)
+                    {
+                        c->fPortRating      = value;
+                        set_rating(chan_id, value, 0);
+                    }
+                }
+            }
+
+            // Write the whole state to the journal when it is started
+            bJournal        = journal;
+            if (start)
+                start_journal();
+        }
+
+        void ab_tester::set_selector(size_t selector, size_t offset)
+        {
+            if (selector != nSelector)
+            {
+                if (bJournal)
+                    sJournal.push(nClock + offset, trial_journal::EV_SELECT, selector, selector);
+                nSelector       = selector;
+                lsp_trace("selector = %d", int(nSelector));
+            }
+
+            for (size_t i=0; i<nInChannels; ++i)
+            {
+                in_channel_t *c     = &vInChannels[i];
+                c->sBypass.set_bypass(nSelector != (i / nOutChannels) + 1);
+            }
+        }
+
+        void ab_tester::set_blind_test(bool blind, size_t offset)
+        {
+            if (blind == bBlindTest)
+                return;
+
+            // The blind test needs at least two inputs to choose from
+            uint32_t items[8];
+            if ((blind) && (blind_inputs(items) < 2))
+                return;
+
+            if (bJournal)
+                sJournal.push(nClock + offset, trial_journal::EV_BLIND, 0, blind);
+            bBlindTest      = blind;
+
+            // Each blind test starts with the new permutation
+            if (blind)
+                shuffle(offset);
+        }
+
+        size_t ab_tester::blind_inputs(uint32_t *items) const
+        {
+            // Collect used inputs that take part in the blind test, inputs without the switch always do
+            const size_t inputs = nActive / nOutChannels;
+            size_t count        = 0;
+            for (size_t i=0; (i<inputs) && (i<8); ++i)
+            {
+                const in_channel_t *c   = &vInChannels[i * nOutChannels];
+                if ((c->pBlindSel == NULL) || (c->pBlindSel->value() >= 0.5f))
+                    items[count++]          = i | 0x8;
+            }
+
+            return count;
+        }
+
+        bool ab_tester::shuffle(size_t offset)
+        {
+            uint32_t items[8];
+            const size_t count  = blind_inputs(items);
+            if (count < 2)
+                return false;
+
+            // Shuffle them with Fisher-Yates algorithm
+            for (size_t i=count-1; i > 0; --i)
+            {
+                nRandom            ^= nRandom << 13;
+                nRandom            ^= nRandom >> 17;
+                nRandom            ^= nRandom << 5;
+                lsp::swap(items[i], items[nRandom % (i + 1)]);
+            }
+
+            // The permutation is applied immediately, the UI receives it later
+            nShuffle            = 0;
+            for (size_t i=0; i<count; ++i)
+                nShuffle           |= items[i] << (4 * i);
+            bShufflePub         = true;
+            publish_shuffle();
+
+            if (bJournal)
+                sJournal.push(nClock + offset, trial_journal::EV_SHUFFLE, 0, nShuffle);
+
+            // Shuffling always clears the selector
+            set_selector(0, offset);
+
+            return true;
+        }
+
+        void ab_tester::publish_shuffle()
+        {
+            // Never wait for the KVT lock, the permutation is published on the next attempt
+            core::KVTStorage *kvt   = pWrapper->kvt_trylock();
+            if (kvt == NULL)
+                return;
+            lsp_finally { pWrapper->kvt_release(); };
+
+            core::kvt_param_t kparam;
+            kparam.type         = core::KVT_UINT32;
+            kparam.u32          = nShuffle;
+            if (kvt->put(KVT_SHUFFLE_INDICES, &kparam, core::KVT_TO_UI) == STATUS_OK)
+                bShufflePub         = false;
+        }
+
+        uint64_t ab_tester::remote_state() const
+        {
+            // Ratings in bits 0-31, selector in bits 32-35, blind test switch in bit 36, mono switch
+            // in bit 37. Bits 40-50 mark values that differ from the ports, they have been changed
+            // by MIDI or OSC and should be written to the ports by the UI
+            uint64_t state      = (uint64_t(nSelector & 0xf) << 32) |
+                                  ((bBlindTest) ? (uint64_t(1) << 36) : 0) |
+                                  ((bMono) ? (uint64_t(1) << 37) : 0);
+            if (nSelector != size_t(lsp_max(0.0f, pChannelSel->value())))
+                state              |= uint64_t(1) << 48;
+            if (bBlindTest != (pBlindTest->value() >= 0.5f))
+                state              |= uint64_t(1) << 49;
+            if ((pMono != NULL) && (bMono != (pMono->value() >= 0.5f)))
+                state              |= uint64_t(1) << 50;
+
+            for (size_t i=0, n=nInChannels / nOutChannels; (i<n) && (i<8); ++i)
+            {
+                const in_channel_t *c   = &vInChannels[i * nOutChannels];
+                if (c->pRating == NULL)
+                    continue;
+                state              |= uint64_t(c->nRating & 0xf) << (4 * i);
+                if (c->nRating != size_t(c->pRating->value()))
+                    state              |= uint64_t(1) << (40 + i);
+            }
+
+            return state;
+        }
+
+        void ab_tester::publish_remote_state(uint64_t state)
+        {
+            // Never wait for the KVT lock, the state is published on the next attempt
+            core::KVTStorage *kvt   = pWrapper->kvt_trylock();
+            if (kvt == NULL)
+                return;
+            lsp_finally { pWrapper->kvt_release(); };
+
+            // The UI applies the state to the ports, so the port values follow the remote control
+            core::kvt_param_t kparam;
+            kparam.type         = core::KVT_UINT64;
+            kparam.u64          = state;
+            if (kvt->put(KVT_REMOTE_STATE, &kparam, core::KVT_TO_UI | core::KVT_TRANSIENT) == STATUS_OK)
+                nRemotePub          = state;
+        }
+
+        void ab_tester::state_loaded()
+        {
+            const uint64_t start    = process_timer::now();
+
+            // Called outside of the audio thread, so it can wait for the KVT
+            core::KVTStorage *kvt   = pWrapper->kvt_lock();
+            if (kvt != NULL)
+            {
+                lsp_finally { pWrapper->kvt_release(); };
+
+                const core::kvt_param_t *p;
+                nLoadShuffle            = (kvt->get(KVT_SHUFFLE_INDICES, &p, core::KVT_UINT32) == STATUS_OK) ? p->u32 : 0;
+                atomic_store(&nStateLoaded, 1);
+            }
+
+            nStateReadTime          = process_timer::now() - start;
+        #ifdef LSP_AB_TESTER_TRACE
+            tracer::record("state_loaded.kvt_read", start, start + nStateReadTime);
+        #endif /* LSP_AB_TESTER_TRACE */
+            lsp_trace("%s restored state read from KVT in %.3f ms", pMetadata->uid, nStateReadTime * 1e-6);
+        }
+
+        void ab_tester::apply_loaded_state()
+        {
+            atomic_store(&nStateLoaded, 0);
+
+            // The restored permutation replaces the one generated for the restored blind test switch
+            if ((!bBlindTest) || (nLoadShuffle == 0) || (nLoadShuffle == nShuffle))
+                return;
+
+            // The permutation should hold each input taking part in the blind test exactly once,
+            // the set of inputs could be changed since it has been saved
+            uint32_t items[8];
+            uint32_t expected   = 0, found = 0;
+            const size_t count  = blind_inputs(items);
+            for (size_t i=0; i<count; ++i)
+                expected           |= 1 << (items[i] & 0x7);
+            for (size_t i=0; i<count; ++i)
+            {
+                const uint32_t item = (nLoadShuffle >> (4 * i)) & 0xf;
+                if (item & 0x8)
+                    found              |= 1 << (item & 0x7);
+            }
+            if ((found != expected) || ((count < 8) && ((nLoadShuffle >> (4 * count)) != 0)))
+            {
+                lsp_trace("Restored shuffle permutation 0x%08x does not match the inputs, reshuffling", nLoadShuffle);
+                shuffle(0);
+                return;
+            }
+
+            // The KVT may already hold the generated permutation, so publish the restored one again
+            nShuffle            = nLoadShuffle;
+            bShufflePub         = true;
+            if (bJournal)
+                sJournal.push(nClock, trial_journal::EV_SHUFFLE, 0, nShuffle);
+        }
+
+        size_t ab_tester::blind_channel(size_t index) const
+        {
+            // In the blind test mode the index is the position of the channel in the shuffled list
+            if ((!bBlindTest) || (index <= 0))
+                return index;
+            if (index > 8)
+                return 0;
+
+            // Empty positions of the shuffled list select nothing
+            uint32_t item       = (nShuffle >> (4 * (index - 1))) & 0xf;
+            return (item & 0x8) ? (item & 0x7) + 1 : 0;
+        }
+
+        size_t ab_tester::remote_inputs() const
+        {
+            if (nOutChannels <= 0)
+                return 0;
+            if (!bBlindTest)
+                return nActive / nOutChannels;
+
+            // Only the shuffled positions can be selected in the blind test mode
+            size_t count        = 0;
+            while ((count < 8) && (nShuffle & (0x8 << (4 * count))))
+                ++count;
+            return count;
+        }
+
+        bool ab_tester::midi_overlap() const
+        {
+            // In the note mode the selector takes the base note and the notes of all inputs
+            const ssize_t sel_last  = (nMidiType == meta::ab_tester::MIDI_NOTE) ?
+                                      nMidiSel + ssize_t(nInChannels / nOutChannels) : nMidiSel;
+            const ssize_t list[]    = { nMidiBlind, nMidiShuffle, nMidiMono };
+
+            for (size_t i=0; i<3; ++i)
+            {
+                const ssize_t v     = list[i];
+                if (v < 0)
+                    continue;
+                if ((nMidiSel >= 0) && (v >= nMidiSel) && (v <= sel_last))
+                    return true;
+                for (size_t j=i+1; j<3; ++j)
+                    if (v == list[j])
+                        return true;
+            }
+
+            return false;
+        }
+
+        void ab_tester::process_midi_event(const midi::event_t *ev, size_t offset)
+        {
+            if ((nMidiChannel > 0) && (ev->channel != nMidiChannel - 1))
+                return;
+
+            const size_t inputs = remote_inputs();
+
+            if (nMidiType == meta::ab_tester::MIDI_NOTE)
+            {
+                // Each note-on event selects the channel or toggles the switch
+                if ((ev->type != midi::MIDI_MSG_NOTE_ON) || (ev->note.velocity == 0))
+                    return;
+
+                // Disabled controls are set to -1 and never match, overlapping controls are matched in order
+                const ssize_t note  = ev->note.pitch;
+                if ((nMidiSel >= 0) && (note >= nMidiSel) && (note <= nMidiSel + ssize_t(inputs)))
+                    set_selector(blind_channel(note - nMidiSel), offset);
+                else if (note == nMidiBlind)
+                    set_blind_test(!bBlindTest, offset);
+                else if (note == nMidiShuffle)
+                    shuffle(offset);
+                else if (note == nMidiMono)
+                    bMono           = !bMono;
+            }
+            else
+            {
+                // The value of the controller selects the channel or sets the state of the switch
+                if (ev->type != midi::MIDI_MSG_NOTE_CONTROLLER)
+                    return;
+
+                // Disabled controls are set to -1 and never match
+                const ssize_t ctl   = ev->ctl.control;
+                const bool on       = ev->ctl.value >= 0x40;
+                if (ctl == nMidiSel)
+                {
+                    if (ev->ctl.value <= inputs)
+                        set_selector(blind_channel(ev->ctl.value), offset);
+                }
+                else if (ctl == nMidiBlind)
+                    set_blind_test(on, offset);
+                else if ((ctl == nMidiShuffle) && (on))
+                    shuffle(offset);
+                else if (ctl == nMidiMono)
+                    bMono           = on;
+            }
+        }
+
+        void ab_tester::set_rating(size_t channel, size_t rating, size_t offset)
+        {
+            in_channel_t *c     = &vInChannels[(channel - 1) * nOutChannels];
+            if (rating == c->nRating)
+                return;
+
+            if (bJournal)
+                sJournal.push(nClock + offset, trial_journal::EV_RATING, channel, rating);
+            c->nRating          = rating;
+        }
+
+        void ab_tester::process_osc_command(const osc_listener::command_t *cmd)
+        {
+            const size_t inputs = remote_inputs();
+
+            switch (cmd->nCommand)
+            {
+                case osc_listener::CMD_SELECT:
+                    if (cmd->nValue <= inputs)
+                        set_selector(blind_channel(cmd->nValue), 0);
+                    break;
+
+                case osc_listener::CMD_RATING:
+                {
+                    if ((cmd->nChannel <= 0) || (cmd->nChannel > inputs))
+                        break;
+                    const size_t channel    = blind_channel(cmd->nChannel);
+                    if (channel <= 0)
+                        break;
+                    size_t rating       = cmd->nValue;
+                    if (rating < meta::ab_tester::RATE_MIN)
+                        rating              = meta::ab_tester::RATE_MIN;
+                    else if (rating > meta::ab_tester::RATE_MAX)
+                        rating              = meta::ab_tester::RATE_MAX;
+                    set_rating(channel, rating, 0);
+                    break;
+                }
+
+                default:
+                    break;
+            }
+        }
+
+        void ab_tester::start_journal()
+        {
+            // Write the initial state
+            sJournal.push(nClock, trial_journal::EV_START, 0, fSampleRate);
+            sJournal.push(nClock, trial_journal::EV_BLIND, 0, bBlindTest);
+            sJournal.push(nClock, trial_journal::EV_SELECT, nSelector, nSelector);
+            for (size_t i=0; i<nInChannels; i += nOutChannels)
+            {
+                in_channel_t *c     = &vInChannels[i];
+                if (c->pRating != NULL)
+                    sJournal.push(nClock, trial_journal::EV_RATING, (i / nOutChannels) + 1, c->nRating);
+            }
+
+            if (nShuffle != 0)
+                sJournal.push(nClock, trial_journal::EV_SHUFFLE, 0, nShuffle);
+        }
+
+        void ab_tester::process_journal(size_t samples)
+        {
+            // Update the path to the journal file
+            plug::path_t *path  = pJournalFile->buffer<plug::path_t>();
+            if ((path != NULL) && (path->pending()) && (sJournal.idle()))
+            {
+                path->accept();
+                sJournal.set_path(path->path());
+                path->commit();
+            }
+
+            // Apply the state restored by the host
+            if (atomic_load(&nStateLoaded))
+                apply_loaded_state();
+
+            // Publish the shuffle permutation that could not be published immediately
+            if (bShufflePub)
+                publish_shuffle();
+
+            if (((bJournal) || (bBlindTest)) && (!bShufflePub))
+            {
+                // Poll the shuffle state restored with the KVT, never wait for the KVT lock
+                if (nShufflePoll <= samples)
+                {
+                    core::KVTStorage *kvt   = pWrapper->kvt_trylock();
+                    if (kvt != NULL)
+                    {
+                        lsp_finally { pWrapper->kvt_release(); };
+
+                        const core::kvt_param_t *p;
+                        if ((kvt->get(KVT_SHUFFLE_INDICES, &p, core::KVT_UINT32) == STATUS_OK) && (p->u32 != nShuffle))
+                        {
+                            nShuffle                = p->u32;
+                            if (bJournal)
+                                sJournal.push(nClock, trial_journal::EV_SHUFFLE, 0, nShuffle);
+                        }
+                        nShufflePoll            = dspu::seconds_to_samples(fSampleRate, JOURNAL_POLL_PERIOD);
+                    }
+                }
+                else
+                    nShufflePoll           -= samples;
+            }
+
+            nClock         += samples;
+            sJournal.submit(pExecutor);
+        }
+
+        status_t ab_tester::load_file(afile_t *af)
+        {
+            // Destroy previously used sample
+            destroy_sample(af->pLoaded);
+
+            // Obtain the file name
+            plug::path_t *path  = af->pFile->buffer<plug::path_t>();
+            if (path == NULL)
+                return STATUS_UNKNOWN_ERR;
+            const char *fname   = path->path();
+            if (strlen(fname) <= 0)
+                return STATUS_UNSPECIFIED;
+
+            // Decode the file and resample it once at load time, the file is stored in memory,
+            // so only the head of the file not longer than the limit is loaded
+            dspu::Sample *s     = new dspu::Sample();
+            if (s == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { destroy_sample(s); };
+
+            status_t res        = s->load(fname, meta::ab_tester::FILE_LEN_MAX);
+            if (res != STATUS_OK)
+            {
+                lsp_warn("Error loading file %s, code=%d", fname, int(res));
+                return res;
+            }
+            if ((res = s->resample(fSampleRate)) != STATUS_OK)
+                return res;
+
+            lsp_trace("Loaded file %s: channels=%d, length=%d", fname, int(s->channels()), int(s->length()));
+            lsp::swap(af->pLoaded, s);
+
+            return STATUS_OK;
+        }
+
+        void ab_tester::process_file_requests()
+        {
+            bool changed        = false;
+
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                afile_t *af         = &vFiles[i];
+                plug::path_t *path  = af->pFile->buffer<plug::path_t>();
+                if (path == NULL)
+                    continue;
+
+                if (af->pLoader->idle())
+                {
+                    // Submit loading task if there is a pending request
+                    if (((path->pending()) || (af->bReload)) && (pExecutor->submit(af->pLoader)))
+                    {
+                        af->bReload         = false;
+                        if (path->pending())
+                            path->accept();
+                    }
+                }
+                else if (af->pLoader->completed())
+                {
+                    // Commit the loaded sample, the previous one will be destroyed by the next load
+                    lsp::swap(af->pSample, af->pLoaded);
+                    af->pLoader->reset();
+                    if (path->accepted())
+                        path->commit();
+                    changed             = true;
+                }
+            }
+
+            if (!changed)
+                return;
+
+            // Update the length of the file playback
+            nFileLength         = 0;
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                dspu::Sample *s     = vFiles[i].pSample;
+                if (s != NULL)
+                    nFileLength         = lsp_max(nFileLength, s->length());
             }
+            if (nFilePos >= nFileLength)
+                nFilePos            = 0;
+        }
+
+        status_t ab_tester::allocate_loop()
+        {
+            // The audio thread does not access the arena while the capture waits for the allocation
+            if (pLoopData != NULL)
+            {
+                free_aligned(pLoopData);
+                pLoopData           = NULL;
+            }
+            nLoopCap            = 0;
+
+            // Long loops are spilled to disk, the arena is not needed for them
+            size_t capacity     = nLoopRequest;
+            if (capacity > nLoopRamMax)
+            {
+                if (sSpill.capacity() > 0)
+                    return STATUS_OK;
+
+                status_t res        = sSpill.init(
+                    nInChannels,
+                    dspu::seconds_to_samples(fSampleRate, meta::ab_tester::LOOP_LEN_MAX),
+                    dspu::seconds_to_samples(fSampleRate, SPILL_RING_LEN),
+                    dspu::seconds_to_samples(fSampleRate, SPILL_PREFETCH_LEN));
+                if (res == STATUS_OK)
+                    return res;
+
+                // Fall back to the longest loop stored in memory
+                lsp_warn("Loop spill is not available, code=%d", int(res));
+                capacity            = nLoopRamMax;
+            }
+
+            // Pages of the arena are not touched until the capture writes to them
+            size_t szof_loop    = align_size(capacity * sizeof(float), DEFAULT_ALIGN);
+            uint8_t *ptr        = alloc_aligned<uint8_t>(pLoopData, szof_loop * nInChannels, DEFAULT_ALIGN);
+            if (ptr == NULL)
+                return STATUS_NO_MEM;
+            nLoopCap            = capacity;
+
+            return STATUS_OK;
+        }
+
+        void ab_tester::process_loop_requests()
+        {
+            if (sLoopAlloc.completed())
+            {
+                // Bind channels to the new arena and start the capture with the storage that is available
+                size_t szof_loop    = align_size(nLoopCap * sizeof(float), DEFAULT_ALIGN);
+                uint8_t *ptr        = pLoopData;
+                for (size_t i=0; i<nInChannels; ++i)
+                    vInChannels[i].vLoop    = (ptr != NULL) ? advance_ptr_bytes<float>(ptr, szof_loop) : NULL;
+
+                sLoopAlloc.reset();
+                if (bLoopArmed)
+                    start_capture();
+                return;
+            }
+
+            if ((!bLoopArmed) || (!sLoopAlloc.idle()))
+                return;
+
+            // Loops that fit into memory are stored in the arena sized by the requested length
+            // rounded up to a second, longer loops are spilled to disk
+            size_t capacity     = nLoopLength;
+            if (capacity <= nLoopRamMax)
+            {
+                const size_t sr     = lsp_max(size_t(fSampleRate), size_t(1));
+                capacity            = lsp_min(((capacity + sr - 1) / sr) * sr, nLoopRamMax);
+                if ((capacity <= nLoopCap) && (capacity * 2 > nLoopCap))
+                {
+                    start_capture();
+                    return;
+                }
+            }
+            else if (sSpill.capacity() > 0)
+            {
+                start_capture();
+                return;
+            }
+
+            nLoopRequest        = capacity;
+            if (!pExecutor->submit(&sLoopAlloc))
+                start_capture();
+        }
+
+        void ab_tester::start_capture()
+        {
+            bLoopArmed          = false;
+            bLoopSpill          = (nLoopLength > nLoopCap) && (sSpill.capacity() > 0);
+            nLoopLimit          = (bLoopSpill) ? sSpill.capacity() : nLoopCap;
+            nLoopSize           = 0;
+            nLoopPos            = 0;
+            if (bLoopSpill)
+                sSpill.reset();
+        }
+
+        size_t ab_tester::footprint() const
+        {
+            size_t size         = sizeof(ab_tester) + nDataSize;
+            size               += align_size(nLoopCap * sizeof(float), DEFAULT_ALIGN) * nInChannels;
+            size               += sSpill.footprint();
+            size               += sJournal.footprint();
+            size               += sOsc.footprint();
+
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                const afile_t *af   = &vFiles[i];
+                size               += sizeof(FileLoader);
+                if (af->pSample != NULL)
+                    size               += sizeof(dspu::Sample) + af->pSample->max_length() * af->pSample->channels() * sizeof(float);
+                if (af->pLoaded != NULL)
+                    size               += sizeof(dspu::Sample) + af->pLoaded->max_length() * af->pLoaded->channels() * sizeof(float);
+            }
+
+            return size;
         }
 
         void ab_tester::process(size_t samples)
         {
+            // Handle file load requests
+            process_file_requests();
+            process_loop_requests();
+
             // Bind input and output buffers
             for (size_t i=0; i<nInChannels; ++i)
             {
@@ -249,52 +1287,391 @@ namespace lsp
                 c->vOut             = c->pOut->buffer<float>();
                 dsp::fill_zero(c->vOut, samples);
             }
+            nInStride           = 1;
+            nOutStride          = 1;
+
+            do_process(samples);
+        }
+
+        void ab_tester::process_interleaved(float *dst, const float *src, size_t samples)
+        {
+            // Handle file load requests
+            process_file_requests();
+            process_loop_requests();
+
+            // Bind input and output frames
+            for (size_t i=0; i<nInChannels; ++i)
+            {
+                in_channel_t *c     = &vInChannels[i];
+                c->vIn              = &src[i];
+
+                core::AudioBuffer *ret  = c->pRet->buffer<core::AudioBuffer>();
+                c->vRet                 = ((ret!= NULL) && (ret->active())) ? ret->buffer() : NULL;
+            }
+            for (size_t i=0; i<nOutChannels; ++i)
+                vOutChannels[i].vOut    = &dst[i];
+            dsp::fill_zero(dst, samples * nOutChannels);
+            nInStride           = nInChannels;
+            nOutStride          = nOutChannels;
+
+            do_process(samples);
+        }
+
+        void ab_tester::process_capture(in_channel_t *in, size_t samples)
+        {
+            float *buf          = in->vCapture;
+            if (buf == NULL)
+                return;
+
+            // Store input signal together with the return for the loop, the gain is applied to the stored signal
+            const float *src    = in->vSrc;
+            if (src != NULL)
+                gather(buf, src, in->nSrcStride, samples);
+            else
+                dsp::fill_zero(buf, samples);
+            if (in->vSrcRet != NULL)
+                dsp::add2(buf, in->vSrcRet, samples);
+
+            in->vSrc            = buf;
+            in->vSrcRet         = NULL;
+            in->nSrcStride      = 1;
+        }
+
+        void ab_tester::process_gain(const in_channel_t *in, float *dst, size_t samples) const
+        {
+            AB_TRACE_SCOPE("process.gain");
+            const float *src    = in->vSrc;
+            const float *ret    = in->vSrcRet;
+
+            // Spilled data that is not resident yet and data after the end of file is replaced by silence
+            if (src != NULL)
+            {
+                if (in->nSrcStride != 1)
+                {
+                    gather(dst, src, in->nSrcStride, samples);
+                    src                 = dst;
+                }
+                in->sGain.apply(dst, src, samples);
+            }
+            else
+                dsp::fill_zero(dst, samples);
+            if (ret != NULL)
+                in->sGain.apply_add(dst, ret, samples);
+        }
+
+        void ab_tester::process_bypass(in_channel_t *in, float *dst, size_t samples)
+        {
+            AB_TRACE_SCOPE("process.bypass");
+            in->fLevel          = (bBlindTest) ? 0.0f : dsp::abs_max(dst, samples);
+            in->sBypass.process(dst, NULL, dst, samples);
+        }
+
+        void ab_tester::do_process(size_t samples)
+        {
+            AB_TRACE_SCOPE("process");
+            sTimer.begin();
+
+            plug::midi_t *midi  = pMidiIn->buffer<plug::midi_t>();
+            size_t midi_event   = 0;
+
+            // Apply OSC commands received since the previous block
+            osc_listener::command_t cmd;
+            while (sOsc.fetch(&cmd))
+                process_osc_command(&cmd);
 
             // Main processing loop
             for (size_t offset=0; offset<samples; )
             {
                 size_t block        = lsp_min(samples - offset, BUFFER_SIZE);
 
+                // Apply MIDI events at their positions, the block never crosses the next event
+                if (midi != NULL)
+                {
+                    for ( ; midi_event < midi->nEvents; ++midi_event)
+                    {
+                        const midi::event_t *ev = &midi->vEvents[midi_event];
+                        if (ev->timestamp > offset)
+                        {
+                            block               = lsp_min(block, ev->timestamp - offset);
+                            break;
+                        }
+                        process_midi_event(ev, offset);
+                    }
+                }
+
+                // Loop replay and capture: all input channels share the same position
+                size_t loop_size    = lsp_min(nLoopSize, nLoopLength);
+                size_t loop_limit   = lsp_min(nLoopLimit, nLoopLength);
+                bool replay         = (nLoopMode == meta::ab_tester::LOOP_REPLAY) && (loop_size > 0);
+                bool capture        = (nLoopMode == meta::ab_tester::LOOP_CAPTURE) && (nLoopSize < loop_limit);
+                if (replay)
+                {
+                    if (nLoopPos >= loop_size)
+                        nLoopPos            = 0;
+                    block               = lsp_min(block, loop_size - nLoopPos);
+                    if (bLoopSpill)
+                        sSpill.set_position(nLoopPos, loop_size);
+                }
+
+                // File playback: all files share the same position
+                bool file_play      = (bFilePlay) && (nFileLength > 0) && (!replay);
+                if (file_play)
+                {
+                    if (nFilePos >= nFileLength)
+                        nFilePos            = 0;
+                    block               = lsp_min(block, nFileLength - nFilePos);
+
+                    // Do not cross the end of any file within the block
+                    for (size_t i=0; i<nFiles; ++i)
+                    {
+                        dspu::Sample *s     = vFiles[i].pSample;
+                        if ((s != NULL) && (s->length() > nFilePos))
+                            block               = lsp_min(block, s->length() - nFilePos);
+                    }
+                }
+
+                if (capture)
+                {
+                    block               = lsp_min(block, loop_limit - nLoopSize);
+                    if (bLoopSpill)
+                    {
+                        // Finish the capture if the writer does not keep up with the audio thread
+                        size_t avail        = sSpill.write_limit(nLoopSize);
+                        if (avail > 0)
+                            block               = lsp_min(block, avail);
+                        else
+                        {
+                            nLoopLimit          = nLoopSize;
+                            capture             = false;
+                        }
+                    }
+                }
+
+                // Bind sources of input channels
+                sTimer.restart();
+                for (size_t i=0; i<nActive; ++i)
+                {
+                    in_channel_t *in     = &vInChannels[i];
+                    const float *src     = in->vIn;
+                    const float *ret     = in->vRet;
+                    size_t stride        = nInStride;
+
+                    if (replay)
+                    {
+                        // Stream the captured input signal directly from the arena or the resident spilled data
+                        src                 = (bLoopSpill) ? sSpill.read(i, nLoopPos, block) : &in->vLoop[nLoopPos];
+                        ret                 = NULL;
+                        stride              = 1;
+                    }
+                    else if ((file_play) && (in->pFile->pSample != NULL))
+                    {
+                        // Stream the resident file data, the file is silent after it's end
+                        dspu::Sample *s     = in->pFile->pSample;
+                        size_t channel      = lsp_min(i % nOutChannels, s->channels() - 1);
+                        src                 = (nFilePos < s->length()) ? &s->channel(channel)[nFilePos] : NULL;
+                        ret                 = NULL;
+                        stride              = 1;
+                    }
+
+                    // Input signal together with the return is stored to the arena or the staging buffer
+                    in->vSrc            = src;
+                    in->vSrcRet         = ret;
+                    in->nSrcStride      = stride;
+                    in->vCapture        = (!capture) ? NULL :
+                                          (bLoopSpill) ? sSpill.ring(i, nLoopSize) : &in->vLoop[nLoopSize];
+                }
+
                 // Process input channels
-                for (size_t i=0; i<nInChannels; ++i)
+                for (size_t i=0; i<nActive; ++i)
                 {
                     in_channel_t *in     = &vInChannels[i];
                     out_channel_t *out   = &vOutChannels[i % nOutChannels];
 
-                    dsp::lramp2(vTmp, in->vIn, in->fOldGain, in->fGain, block);
-                    if (in->vRet != NULL)
-                        dsp::lramp_add2(vTmp, in->vRet, in->fOldGain, in->fGain, block);
+                    process_capture(in, block);
+                    process_gain(in, vTmp, block);
+                    in->sGain.advance(block);
+                    sTimer.mark(process_timer::STAGE_GAIN);
 
-                    in->fOldGain        = in->fGain;
-                    float level         = (bBlindTest) ? 0.0f : dsp::abs_max(vTmp, block);
-                    in->sBypass.process(vTmp, NULL, vTmp, block);
-                    in->pInMeter->set_value(level);
+                    process_bypass(in, vTmp, block);
+                    in->pInMeter->set_value(in->fLevel);
+                    sTimer.mark(process_timer::STAGE_BYPASS);
 
                     // Add input channel to output
-                    dsp::add2(out->vOut, vTmp, block);
+                    {
+                        AB_TRACE_SCOPE("process.mix");
+                        scatter_add(out->vOut, vTmp, nOutStride, block);
+                        sTimer.mark(process_timer::STAGE_MIX);
+                    }
                 }
 
                 // Mono switch
                 if ((nOutChannels > 1) && (bMono))
                 {
+                    AB_TRACE_SCOPE("process.mono");
                     float *l        = vOutChannels[0].vOut;
                     float *r        = vOutChannels[1].vOut;
-                    dsp::lr_to_mid(l, l, r, block);
-                    dsp::copy(r, l, block);
+                    if (nOutStride == 1)
+                    {
+                        dsp::lr_to_mid(l, l, r, block);
+                        dsp::copy(r, l, block);
+                    }
+                    else
+                    {
+                        for (size_t i=0; i<block; ++i, l += nOutStride, r += nOutStride)
+                        {
+                            *l              = (*l + *r) * 0.5f;
+                            *r              = *l;
+                        }
+                    }
+                    sTimer.mark(process_timer::STAGE_MONO);
                 }
 
                 // Update pointers
                 offset             += block;
+                if (file_play)
+                    nFilePos           += block;
+                if (replay)
+                    nLoopPos           += block;
+                else if (capture)
+                {
+                    nLoopSize          += block;
+                    if (bLoopSpill)
+                        sSpill.commit(nLoopSize);
+                }
                 for (size_t i=0; i<nInChannels; ++i)
                 {
                     in_channel_t *c         = &vInChannels[i];
-                    c->vIn                 += block;
+                    c->vIn                 += block * nInStride;
                     if (c->vRet != NULL)
                         c->vRet                += block;
                 }
                 for (size_t i=0; i<nOutChannels; ++i)
-                    vOutChannels[i].vOut   += block;
+                    vOutChannels[i].vOut   += block * nOutStride;
             }
+
+            // Update the journal
+            {
+                AB_TRACE_SCOPE("process.journal");
+                process_journal(samples);
+            }
+
+            // Keep the state in the KVT actual, the UI applies values changed by MIDI and OSC
+            const uint64_t remote   = remote_state();
+            if (remote != nRemotePub)
+                publish_remote_state(remote);
+
+            // Launch the OSC listener if it has been enabled
+            sOsc.submit(pExecutor);
+
+            // Let the background tasks flush and prefetch the spilled loop. The head of the loop
+            // is kept resident while the loop is not replayed, so the replay starts without a gap
+            if (bLoopSpill)
+            {
+                const bool capture  = (nLoopMode == meta::ab_tester::LOOP_CAPTURE) &&
+                                      (nLoopSize < lsp_min(nLoopLimit, nLoopLength));
+                if (nLoopMode != meta::ab_tester::LOOP_REPLAY)
+                    sSpill.set_position(0, nLoopSize);
+                sSpill.submit(pExecutor, !capture);
+            }
+
+            // Report loop position
+            size_t loop_pos     = (nLoopMode == meta::ab_tester::LOOP_REPLAY) ? nLoopPos :
+                                  (nLoopMode == meta::ab_tester::LOOP_CAPTURE) ? nLoopSize : 0;
+            pLoopPos->set_value(dspu::samples_to_seconds(fSampleRate, loop_pos));
+
+            // Report DSP load
+            sTimer.end(samples);
+            pDspLoad->set_value(sTimer.load());
+            pDspPeak->set_value(sTimer.peak());
+            update_display();
+        }
+
+        void ab_tester::update_display()
+        {
+            // Levels are quantized to display steps, the redraw is requested only when the picture changes
+            bool changed        = (nDispSelector != nSelector) || (bDispBlind != bBlindTest);
+            nDispSelector       = nSelector;
+            bDispBlind          = bBlindTest;
+
+            for (size_t i=0; i<nActive; ++i)
+            {
+                in_channel_t *in    = &vInChannels[i];
+                const float db      = (in->fLevel > 0.0f) ? dspu::gain_to_db(in->fLevel) : DISPLAY_DB_MIN;
+                const float step    = (db - DISPLAY_DB_MIN) / DISPLAY_DB_STEP;
+                const size_t level  = (step <= 0.0f) ? 0 :
+                                      (step >= float(DISPLAY_STEPS)) ? DISPLAY_STEPS : size_t(step);
+                if (level == in->nDispLevel)
+                    continue;
+
+                in->nDispLevel      = level;
+                changed             = true;
+            }
+
+            if ((changed) && (pWrapper != NULL))
+                pWrapper->query_display_draw();
+        }
+
+        bool ab_tester::inline_display(plug::ICanvas *cv, size_t width, size_t height)
+        {
+            // Check proportions
+            if (height > (M_RGOLD_RATIO * width))
+                height  = M_RGOLD_RATIO * width;
+
+            // Init canvas
+            if (!cv->init(width, height))
+                return false;
+            width   = cv->width();
+            height  = cv->height();
+
+            // Clear background
+            cv->set_color_rgb((bDispBlind) ? CV_DISABLED : CV_BACKGROUND);
+            cv->paint();
+
+            const size_t candidates = (nOutChannels > 0) ? nActive / nOutChannels : 0;
+            if (candidates <= 0)
+                return true;
+
+            const float slot        = float(width) / float(candidates);
+            const float bar         = slot / float(nOutChannels + 1);
+
+            for (size_t i=0; i<candidates; ++i)
+            {
+                const float x           = slot * i;
+
+                // Highlight the selected input, the selection is not revealed in the blind test mode
+                const bool selected     = (!bDispBlind) && (nDispSelector == i + 1);
+                if (selected)
+                {
+                    cv->set_line_width(slot - 2.0f);
+                    cv->set_color_rgb(CV_MESH, 0.5f);
+                    cv->line(x + slot * 0.5f, 0.0f, x + slot * 0.5f, height);
+                }
+
+                // Draw peak bars of the input
+                cv->set_line_width(bar);
+                for (size_t j=0; j<nOutChannels; ++j)
+                {
+                    const in_channel_t *in  = &vInChannels[i * nOutChannels + j];
+                    const float bx          = x + bar * (j + 1);
+                    const float by          = height - (float(height) * in->nDispLevel) / float(DISPLAY_STEPS);
+
+                    cv->set_color_rgb(
+                        (nOutChannels <= 1) ? CV_MIDDLE_CHANNEL :
+                        (j == 0) ? CV_LEFT_CHANNEL : CV_RIGHT_CHANNEL,
+                        (selected) ? 0.0f : 0.5f);
+                    cv->line(bx, height, bx, by);
+                }
+
+                // Separate inputs
+                if (i > 0)
+                {
+                    cv->set_line_width(1.0f);
+                    cv->set_color_rgb(CV_WHITE, 0.75f);
+                    cv->line(x, 0.0f, x, height);
+                }
+            }
+
+            return true;
         }
 
         void ab_tester::dump(dspu::IStateDumper *v) const
@@ -309,8 +1686,23 @@ namespace lsp
                     v->write_object(&in->sBypass);
                     v->write("vIn", in->vIn);
                     v->write("vRet", in->vRet);
-                    v->write("fOldGain", in->fOldGain);
-                    v->write("fGain", in->fGain);
+                    v->write("vLoop", in->vLoop);
+                    v->write("pFile", in->pFile);
+                    v->write("nRating", in->nRating);
+                    v->write("fPortRating", in->fPortRating);
+                    v->write("vSrc", in->vSrc);
+                    v->write("vSrcRet", in->vSrcRet);
+                    v->write("vCapture", in->vCapture);
+                    v->write("nSrcStride", in->nSrcStride);
+                    v->write("fLevel", in->fLevel);
+                    v->write("nDispLevel", in->nDispLevel);
+                    v->write("pRating", in->pRating);
+                    v->write("pBlindSel", in->pBlindSel);
+                    v->begin_object("sGain", &in->sGain, sizeof(gain_smoother));
+                    {
+                        in->sGain.dump(v);
+                    }
+                    v->end_object();
                     v->write("pIn", in->pIn);
                     v->write("pRet", in->pRet);
                     v->write("pGain", in->pGain);
@@ -336,18 +1728,116 @@ namespace lsp
 
             v->write("nInChannels", nInChannels);
             v->write("nOutChannels", nOutChannels);
+            v->write("nInStride", nInStride);
+            v->write("nOutStride", nOutStride);
             v->write("vTmp", vTmp);
             v->write("bBlindTest", bBlindTest);
             v->write("bMono", bMono);
             v->write("nSelector", nSelector);
             v->write("pChannelSel", pChannelSel);
             v->write("pBlindTest", pBlindTest);
-            v->write("bMono", bMono);
-            v->write("nSelector", nSelector);
-            v->write("pChannelSel", pChannelSel);
-            v->write("pBlindTest", pBlindTest);
+            v->write("pShuffle", pShuffle);
             v->write("pMono", pMono);
+            v->begin_array("vFiles", vFiles, nFiles);
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                afile_t *af         = &vFiles[i];
+
+                v->begin_object(af, sizeof(afile_t));
+                {
+                    v->write("pLoader", af->pLoader);
+                    v->write_object("pSample", af->pSample);
+                    v->write_object("pLoaded", af->pLoaded);
+                    v->write("bReload", af->bReload);
+                    v->write("pFile", af->pFile);
+                }
+                v->end_object();
+            }
+            v->end_array();
+
+            v->write("nFiles", nFiles);
+            v->write("nLoopMode", nLoopMode);
+            v->write("nLoopCap", nLoopCap);
+            v->write("nLoopRamMax", nLoopRamMax);
+            v->write("nLoopRequest", nLoopRequest);
+            v->write("bLoopArmed", bLoopArmed);
+            v->write("nLoopLength", nLoopLength);
+            v->write("nLoopSize", nLoopSize);
+            v->write("nLoopPos", nLoopPos);
+            v->write("nLoopLimit", nLoopLimit);
+            v->write("bLoopSpill", bLoopSpill);
+            v->begin_object("sSpill", &sSpill, sizeof(capture_spill));
+            {
+                sSpill.dump(v);
+            }
+            v->end_object();
+            v->write("pExecutor", pExecutor);
+            v->write("bFilePlay", bFilePlay);
+            v->write("nFilePos", nFilePos);
+            v->write("nFileLength", nFileLength);
+            v->write("pFilePlay", pFilePlay);
+            v->begin_object("sJournal", &sJournal, sizeof(trial_journal));
+            {
+                sJournal.dump(v);
+            }
+            v->end_object();
+            v->write("bJournal", bJournal);
+            v->write("nShuffle", nShuffle);
+            v->write("nShufflePoll", nShufflePoll);
+            v->write("nClock", nClock);
+            v->write("pJournal", pJournal);
+            v->write("pJournalFile", pJournalFile);
+            v->write("nMidiChannel", nMidiChannel);
+            v->write("nMidiType", nMidiType);
+            v->write("nMidiSel", nMidiSel);
+            v->write("nMidiBlind", nMidiBlind);
+            v->write("nMidiShuffle", nMidiShuffle);
+            v->write("nMidiMono", nMidiMono);
+            v->write("nRandom", nRandom);
+            v->write("fPortSel", fPortSel);
+            v->write("fPortBlind", fPortBlind);
+            v->write("nBlindSet", nBlindSet);
+            v->write("fPortMono", fPortMono);
+            v->write("fPortShuffle", fPortShuffle);
+            v->write("bShufflePub", bShufflePub);
+            v->write("nRemotePub", nRemotePub);
+            v->write("nLoadShuffle", nLoadShuffle);
+            v->write("nStateLoaded", size_t(atomic_load(&nStateLoaded)));
+            v->write("nStateReadTime", nStateReadTime);
+            v->write("pMidiIn", pMidiIn);
+            v->write("pMidiChannel", pMidiChannel);
+            v->write("pMidiType", pMidiType);
+            v->write("pMidiSel", pMidiSel);
+            v->write("pMidiBlind", pMidiBlind);
+            v->write("pMidiShuffle", pMidiShuffle);
+            v->write("pMidiMono", pMidiMono);
+            v->begin_object("sOsc", &sOsc, sizeof(osc_listener));
+            {
+                sOsc.dump(v);
+            }
+            v->end_object();
+            v->write("pOscOn", pOscOn);
+            v->write("pOscIface", pOscIface);
+            v->write("pOscPort", pOscPort);
+            v->begin_object("sTimer", &sTimer, sizeof(process_timer));
+            {
+                sTimer.dump(v);
+            }
+            v->end_object();
+            v->write("pDspLoad", pDspLoad);
+            v->write("pDspPeak", pDspPeak);
+            v->write("nActive", nActive);
+            v->write("nDispSelector", nDispSelector);
+            v->write("bDispBlind", bDispBlind);
+            v->write("pInputs", pInputs);
+            v->write("pLoopMode", pLoopMode);
+            v->write("pLoopLength", pLoopLength);
+            v->write("pLoopPos", pLoopPos);
+            v->write("sLoopAlloc", &sLoopAlloc);
             v->write("pData", pData);
+            v->write("nDataSize", nDataSize);
+            v->write("pLoopData", pLoopData);
+            v->write("footprint", footprint());
         }
 
     } /* namespace plugins */
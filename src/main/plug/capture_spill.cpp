@@ -0,0 +1,605 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/ipc/Thread.h>
+#include <lsp-plug.in/runtime/system.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+
+#include <private/plugins/capture_spill.h>
+
+#ifdef PLATFORM_POSIX
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <stdlib.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif /* PLATFORM_POSIX */
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /* The number of attempts to read the resident window while the prefetcher updates it */
+        static constexpr size_t WINDOW_READ_ATTEMPTS    = 4;
+
+        //---------------------------------------------------------------------
+        capture_spill::Writer::Writer(capture_spill *spill)
+        {
+            pSpill      = spill;
+        }
+
+        capture_spill::Writer::~Writer()
+        {
+            pSpill      = NULL;
+        }
+
+        status_t capture_spill::Writer::run()
+        {
+            return pSpill->do_flush();
+        }
+
+        capture_spill::Prefetcher::Prefetcher(capture_spill *spill)
+        {
+            pSpill      = spill;
+        }
+
+        capture_spill::Prefetcher::~Prefetcher()
+        {
+            pSpill      = NULL;
+        }
+
+        status_t capture_spill::Prefetcher::run()
+        {
+            return pSpill->do_prefetch();
+        }
+
+        //---------------------------------------------------------------------
+        capture_spill::capture_spill():
+            sWriter(this),
+            sPrefetcher(this)
+        {
+            nChannels       = 0;
+            nCapacity       = 0;
+            nRingSize       = 0;
+            nPrefetch       = 0;
+            vRing           = NULL;
+            vLocked         = NULL;
+            vLockNew        = NULL;
+            nLocked         = 0;
+            nLockNew        = 0;
+            pData           = NULL;
+
+            hFD             = -1;
+            vMap            = NULL;
+            nMapSize        = 0;
+            nPageSize       = 0x1000;
+
+            atomic_store(&nHead, 0);
+            atomic_store(&nFlushed, 0);
+            atomic_store(&nReset, 0);
+            atomic_store(&nFailed, 0);
+            atomic_store(&nReadPos, 0);
+            atomic_store(&nReadSize, 0);
+            atomic_store(&nResSeq, 0);
+            atomic_store(&nResFirst, 0);
+            atomic_store(&nResLast, 0);
+            atomic_store(&nResWrap, 0);
+            atomic_store(&nUnlocked, 0);
+            atomic_store(&nMisses, 0);
+        }
+
+        capture_spill::~capture_spill()
+        {
+            destroy();
+        }
+
+        status_t capture_spill::init(size_t channels, size_t capacity, size_t ring, size_t prefetch)
+        {
+            destroy();
+
+        #ifdef PLATFORM_POSIX
+            // Allocate the staging ring buffer and the lists of locked pages, each channel
+            // has at most two page ranges: ahead of the read position and after the wrap
+            size_t szof_ring    = align_size(ring * sizeof(float), DEFAULT_ALIGN);
+            size_t szof_ranges  = align_size(channels * 2 * sizeof(range_t), DEFAULT_ALIGN);
+            size_t to_alloc     = szof_ring * channels + szof_ranges * 2;
+            uint8_t *ptr        = alloc_aligned<uint8_t>(pData, to_alloc, DEFAULT_ALIGN);
+            if (ptr == NULL)
+                return STATUS_NO_MEM;
+
+            vRing               = advance_ptr_bytes<float>(ptr, szof_ring * channels);
+            vLocked             = advance_ptr_bytes<range_t>(ptr, szof_ranges);
+            vLockNew            = advance_ptr_bytes<range_t>(ptr, szof_ranges);
+            dsp::fill_zero(vRing, (szof_ring * channels) / sizeof(float));
+
+            long page_size      = sysconf(_SC_PAGESIZE);
+            nPageSize           = (page_size > 0) ? page_size : 0x1000;
+            nChannels           = channels;
+            nCapacity           = capacity;
+            nRingSize           = szof_ring / sizeof(float);
+            nPrefetch           = prefetch;
+
+            // The file is created here, so the caller can fall back to memory if it is not available
+            status_t res        = open_file();
+            if (res != STATUS_OK)
+                destroy();
+
+            return res;
+        #else
+            return STATUS_NOT_SUPPORTED;
+        #endif /* PLATFORM_POSIX */
+        }
+
+        void capture_spill::destroy()
+        {
+            wait_tasks();
+
+            // Unmapping the file also unlocks all it's pages
+            close_file();
+
+            if (pData != NULL)
+            {
+                free_aligned(pData);
+                pData           = NULL;
+            }
+
+            vRing           = NULL;
+            vLocked         = NULL;
+            vLockNew        = NULL;
+            nLocked         = 0;
+            nLockNew        = 0;
+            nChannels       = 0;
+            nCapacity       = 0;
+            nRingSize       = 0;
+
+            atomic_store(&nHead, 0);
+            atomic_store(&nFlushed, 0);
+            atomic_store(&nReset, 0);
+            atomic_store(&nFailed, 0);
+            atomic_store(&nResSeq, 0);
+            atomic_store(&nResFirst, 0);
+            atomic_store(&nResLast, 0);
+            atomic_store(&nResWrap, 0);
+            atomic_store(&nUnlocked, 0);
+            atomic_store(&nMisses, 0);
+        }
+
+        void capture_spill::wait_tasks()
+        {
+            while ((!sWriter.idle()) && (!sWriter.completed()))
+                ipc::Thread::sleep(10);
+            while ((!sPrefetcher.idle()) && (!sPrefetcher.completed()))
+                ipc::Thread::sleep(10);
+
+            if (sWriter.completed())
+                sWriter.reset();
+            if (sPrefetcher.completed())
+                sPrefetcher.reset();
+        }
+
+        status_t capture_spill::open_file()
+        {
+        #ifdef PLATFORM_POSIX
+            if (hFD >= 0)
+                return STATUS_OK;
+
+            // Create anonymous temporary file
+            io::Path path;
+            status_t res = system::get_temporary_dir(&path);
+            if (res != STATUS_OK)
+                return res;
+            if ((res = path.append_child("lsp-ab-tester-XXXXXX")) != STATUS_OK)
+                return res;
+
+            char name[PATH_MAX];
+            snprintf(name, sizeof(name), "%s", path.as_native());
+            int fd = mkstemp(name);
+            if (fd < 0)
+                return STATUS_IO_ERROR;
+            unlink(name);
+
+            // Reserve the space for planar data, the file remains sparse until written
+            size_t map_size = nChannels * nCapacity * sizeof(float);
+            if (ftruncate(fd, map_size) != 0)
+            {
+                close(fd);
+                return STATUS_IO_ERROR;
+            }
+
+            void *map = mmap(NULL, map_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (map == MAP_FAILED)
+            {
+                close(fd);
+                return STATUS_NO_MEM;
+            }
+
+            hFD             = fd;
+            vMap            = static_cast<float *>(map);
+            nMapSize        = map_size;
+
+            lsp_trace("Opened spill file %s, size=%lld", name, (long long)map_size);
+
+            return STATUS_OK;
+        #else
+            return STATUS_NOT_SUPPORTED;
+        #endif /* PLATFORM_POSIX */
+        }
+
+        void capture_spill::close_file()
+        {
+        #ifdef PLATFORM_POSIX
+            if (vMap != NULL)
+            {
+                munmap(vMap, nMapSize);
+                vMap            = NULL;
+                nMapSize        = 0;
+            }
+            if (hFD >= 0)
+            {
+                close(hFD);
+                hFD             = -1;
+            }
+        #endif /* PLATFORM_POSIX */
+        }
+
+        status_t capture_spill::do_flush()
+        {
+        #ifdef PLATFORM_POSIX
+            if ((hFD < 0) || (atomic_load(&nFailed)))
+                return STATUS_BAD_STATE;
+
+            // Handle the reset request. The resident window is owned by the prefetcher and remains
+            // valid: it describes the pages of the file, and read() checks the flushed range anyway
+            if (atomic_swap(&nReset, 0))
+                atomic_store(&nFlushed, 0);
+
+            size_t flushed  = atomic_load(&nFlushed);
+            size_t head     = atomic_load(&nHead);
+
+            while (flushed < head)
+            {
+                // Write contiguous part of the ring buffer for each channel
+                size_t off      = flushed % nRingSize;
+                size_t count    = lsp_min(head - flushed, nRingSize - off);
+
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    const uint8_t *src  = reinterpret_cast<const uint8_t *>(&vRing[i * nRingSize + off]);
+                    off_t pos           = (off_t(i) * nCapacity + flushed) * sizeof(float);
+                    size_t bytes        = count * sizeof(float);
+
+                    while (bytes > 0)
+                    {
+                        ssize_t written     = pwrite(hFD, src, bytes, pos);
+                        if (written < 0)
+                        {
+                            if (errno == EINTR)
+                                continue;
+
+                            // The storage is not usable anymore, the capture stops on the full ring
+                            lsp_warn("Could not write the spill file, errno=%d", int(errno));
+                            atomic_store(&nFailed, 1);
+                            return STATUS_IO_ERROR;
+                        }
+                        src                += written;
+                        pos                += written;
+                        bytes              -= written;
+                    }
+                }
+
+                // The audio thread could request reset while we were writing
+                if (atomic_load(&nReset))
+                    return STATUS_OK;
+
+                flushed        += count;
+                atomic_store(&nFlushed, flushed);
+            }
+
+            return STATUS_OK;
+        #else
+            return STATUS_NOT_SUPPORTED;
+        #endif /* PLATFORM_POSIX */
+        }
+
+        void capture_spill::touch_range(size_t first, size_t last)
+        {
+        #ifdef PLATFORM_POSIX
+            if (first >= last)
+                return;
+
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                const uint8_t *head = reinterpret_cast<const uint8_t *>(&vMap[i * nCapacity + first]);
+                const uint8_t *tail = reinterpret_cast<const uint8_t *>(&vMap[i * nCapacity + last]);
+                uint8_t *page       = reinterpret_cast<uint8_t *>(uintptr_t(head) & ~uintptr_t(nPageSize - 1));
+
+                madvise(page, tail - page, MADV_WILLNEED);
+
+                // Touch each page to make it resident
+                volatile uint8_t sum = 0;
+                for ( ; page < tail; page += nPageSize)
+                    sum    += *page;
+            }
+        #endif /* PLATFORM_POSIX */
+        }
+
+        size_t capture_spill::page_range(range_t *dst, size_t channel, size_t first, size_t last) const
+        {
+            if (first >= last)
+                return 0;
+
+            // The mapping is page-aligned and it's size is rounded up to the page by the kernel
+            const uintptr_t mask    = nPageSize - 1;
+            const uintptr_t head    = uintptr_t(&vMap[channel * nCapacity + first]);
+            const uintptr_t tail    = uintptr_t(&vMap[channel * nCapacity + last]);
+
+            dst->pFirst     = reinterpret_cast<uint8_t *>(head & ~mask);
+            dst->pLast      = reinterpret_cast<uint8_t *>((tail + mask) & ~mask);
+
+            return 1;
+        }
+
+        bool capture_spill::lock_pages(const range_t *list, size_t count)
+        {
+        #ifdef PLATFORM_POSIX
+            // The pages are read from the disk by mlock() if they are not resident yet
+            for (size_t i=0; i<count; ++i)
+            {
+                const range_t *r    = &list[i];
+                if (mlock(r->pFirst, r->pLast - r->pFirst) != 0)
+                    return false;
+            }
+            return true;
+        #else
+            return false;
+        #endif /* PLATFORM_POSIX */
+        }
+
+        void capture_spill::unlock_pages(uint8_t *first, uint8_t *last, size_t index)
+        {
+        #ifdef PLATFORM_POSIX
+            // Pages are not reference-counted by mlock(), so keep locked the parts of the new window
+            for ( ; index < nLockNew; ++index)
+            {
+                const range_t *r    = &vLockNew[index];
+                if ((r->pLast <= first) || (r->pFirst >= last))
+                    continue;
+
+                if (first < r->pFirst)
+                    unlock_pages(first, r->pFirst, index + 1);
+                if (r->pLast < last)
+                    unlock_pages(r->pLast, last, index + 1);
+                return;
+            }
+
+            munlock(first, last - first);
+        #endif /* PLATFORM_POSIX */
+        }
+
+        void capture_spill::publish_window(size_t first, size_t last, size_t wrap)
+        {
+            // The prefetcher is the only writer, readers retry or fail while the counter is odd
+            atomic_add(&nResSeq, 1);
+            atomic_store(&nResFirst, first);
+            atomic_store(&nResLast, last);
+            atomic_store(&nResWrap, wrap);
+            atomic_add(&nResSeq, 1);
+        }
+
+        bool capture_spill::resident_window(window_t *w) const
+        {
+            for (size_t i=0; i<WINDOW_READ_ATTEMPTS; ++i)
+            {
+                const uatomic_t seq = atomic_load(&nResSeq);
+                if (seq & 1)
+                    continue;
+
+                w->nFirst       = atomic_load(&nResFirst);
+                w->nLast        = atomic_load(&nResLast);
+                w->nWrap        = atomic_load(&nResWrap);
+
+                if (atomic_load(&nResSeq) == seq)
+                    return true;
+            }
+
+            return false;
+        }
+
+        status_t capture_spill::do_prefetch()
+        {
+            if ((vMap == NULL) || (atomic_load(&nReset)))
+                return STATUS_OK;
+
+            size_t flushed  = atomic_load(&nFlushed);
+            size_t size     = lsp_min(size_t(atomic_load(&nReadSize)), flushed);
+            size_t pos      = atomic_load(&nReadPos);
+            if ((size <= 0) || (pos >= size))
+                return STATUS_OK;
+
+            // Compute the window to prefetch
+            size_t last     = lsp_min(pos + nPrefetch, size);
+            size_t wrap     = lsp_min(pos + nPrefetch - last, pos);
+
+            nLockNew        = 0;
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                nLockNew       += page_range(&vLockNew[nLockNew], i, pos, last);
+                nLockNew       += page_range(&vLockNew[nLockNew], i, 0, wrap);
+            }
+
+            // Lock the new window before it is published
+            if (lock_pages(vLockNew, nLockNew))
+                atomic_store(&nUnlocked, 0);
+            else
+            {
+                // Make the pages resident at least for now
+                if (!atomic_swap(&nUnlocked, 1))
+                    lsp_warn("Could not lock the spilled loop in memory, errno=%d", int(errno));
+                touch_range(pos, last);
+                touch_range(0, wrap);
+            }
+
+            publish_window(pos, last, wrap);
+
+            // Unlock the pages of the previous window that are not used anymore
+            for (size_t i=0; i<nLocked; ++i)
+                unlock_pages(vLocked[i].pFirst, vLocked[i].pLast, 0);
+
+            lsp::swap(vLocked, vLockNew);
+            nLocked         = nLockNew;
+            nLockNew        = 0;
+
+            return STATUS_OK;
+        }
+
+        size_t capture_spill::capacity() const
+        {
+            return ((vMap == NULL) || (atomic_load(&nFailed))) ? 0 : nCapacity;
+        }
+
+        void capture_spill::reset()
+        {
+            atomic_store(&nHead, 0);
+            atomic_store(&nReset, 1);
+        }
+
+        size_t capture_spill::write_limit(size_t pos) const
+        {
+            if ((nRingSize <= 0) || (atomic_load(&nFailed)))
+                return 0;
+
+            // Until the reset is handled by the writer, consider nothing being flushed
+            size_t flushed  = (atomic_load(&nReset)) ? 0 : atomic_load(&nFlushed);
+            if (flushed > pos)
+                return 0;
+
+            size_t avail    = nRingSize - lsp_min(pos - flushed, nRingSize);
+            return lsp_min(avail, nRingSize - (pos % nRingSize));
+        }
+
+        float *capture_spill::ring(size_t channel, size_t pos)
+        {
+            return &vRing[channel * nRingSize + (pos % nRingSize)];
+        }
+
+        void capture_spill::commit(size_t pos)
+        {
+            atomic_store(&nHead, pos);
+        }
+
+        void capture_spill::set_position(size_t pos, size_t size)
+        {
+            atomic_store(&nReadPos, pos);
+            atomic_store(&nReadSize, size);
+        }
+
+        const float *capture_spill::read(size_t channel, size_t pos, size_t count)
+        {
+            if ((atomic_load(&nReset)) || (atomic_load(&nFailed)))
+                return NULL;
+
+            // Check that the requested range is flushed and resident
+            window_t w;
+            size_t last     = pos + count;
+            if ((last > size_t(atomic_load(&nFlushed))) ||
+                (!resident_window(&w)) ||
+                ((!((pos >= w.nFirst) && (last <= w.nLast))) && (last > w.nWrap)))
+            {
+                atomic_add(&nMisses, 1);
+                return NULL;
+            }
+
+            return &vMap[channel * nCapacity + pos];
+        }
+
+        void capture_spill::submit(ipc::IExecutor *executor, bool prefetch)
+        {
+            if ((executor == NULL) || (atomic_load(&nFailed)))
+                return;
+
+            // Writer
+            if (sWriter.completed())
+                sWriter.reset();
+            if ((sWriter.idle()) &&
+                ((atomic_load(&nReset)) || (atomic_load(&nHead) != atomic_load(&nFlushed))))
+                executor->submit(&sWriter);
+
+            // Prefetcher
+            if (sPrefetcher.completed())
+                sPrefetcher.reset();
+            if ((prefetch) && (sPrefetcher.idle()))
+            {
+                // Move the window when less than a half of it remains ahead of the read position
+                window_t w;
+                size_t pos      = atomic_load(&nReadPos);
+                size_t size     = atomic_load(&nReadSize);
+                if (!resident_window(&w))
+                    return;
+
+                size_t ahead    = ((pos >= w.nFirst) && (pos < w.nLast)) ? w.nLast - pos : 0;
+                if ((ahead > 0) && (w.nLast >= size))
+                    ahead          += w.nWrap;
+                if ((w.nLast > size) || (ahead < (lsp_min(nPrefetch, size) >> 1)))
+                    executor->submit(&sPrefetcher);
+            }
+        }
+
+        size_t capture_spill::footprint() const
+        {
+            return nRingSize * nChannels * sizeof(float) + nChannels * 4 * sizeof(range_t);
+        }
+
+        void capture_spill::dump(dspu::IStateDumper *v) const
+        {
+            v->write("nChannels", nChannels);
+            v->write("nCapacity", nCapacity);
+            v->write("nRingSize", nRingSize);
+            v->write("nPrefetch", nPrefetch);
+            v->write("vRing", vRing);
+            v->write("vLocked", vLocked);
+            v->write("vLockNew", vLockNew);
+            v->write("nLocked", nLocked);
+            v->write("nLockNew", nLockNew);
+            v->write("pData", pData);
+            v->write("hFD", hFD);
+            v->write("vMap", vMap);
+            v->write("nMapSize", nMapSize);
+            v->write("nPageSize", nPageSize);
+            v->write("nHead", size_t(atomic_load(&nHead)));
+            v->write("nFlushed", size_t(atomic_load(&nFlushed)));
+            v->write("nReset", size_t(atomic_load(&nReset)));
+            v->write("nFailed", size_t(atomic_load(&nFailed)));
+            v->write("nReadPos", size_t(atomic_load(&nReadPos)));
+            v->write("nReadSize", size_t(atomic_load(&nReadSize)));
+            v->write("nResSeq", size_t(atomic_load(&nResSeq)));
+            v->write("nResFirst", size_t(atomic_load(&nResFirst)));
+            v->write("nResLast", size_t(atomic_load(&nResLast)));
+            v->write("nResWrap", size_t(atomic_load(&nResWrap)));
+            v->write("nUnlocked", size_t(atomic_load(&nUnlocked)));
+            v->write("nMisses", size_t(atomic_load(&nMisses)));
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
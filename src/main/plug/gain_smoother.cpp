@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+
+#include <private/plugins/gain_smoother.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        gain_smoother::gain_smoother()
+        {
+            construct();
+        }
+
+        gain_smoother::~gain_smoother()
+        {
+        }
+
+        void gain_smoother::construct()
+        {
+            fCurrent        = 1.0f;
+            fTarget         = 1.0f;
+            fDelta          = 0.0f;
+            nLeft           = 0;
+            nLength         = 0;
+        }
+
+        void gain_smoother::set_sample_rate(size_t sr)
+        {
+            nLength         = dspu::seconds_to_samples(sr, SMOOTH_TIME);
+            reset(fTarget);
+        }
+
+        void gain_smoother::reset(float gain)
+        {
+            fCurrent        = gain;
+            fTarget         = gain;
+            fDelta          = 0.0f;
+            nLeft           = 0;
+        }
+
+        void gain_smoother::set(float gain)
+        {
+            if (gain == fTarget)
+                return;
+            if (nLength <= 0)
+            {
+                reset(gain);
+                return;
+            }
+
+            // The ramp always starts from the current gain, so the interrupted ramp has no step
+            fTarget         = gain;
+            fDelta          = (fTarget - fCurrent) / nLength;
+            nLeft           = nLength;
+        }
+
+        void gain_smoother::apply(float *dst, const float *src, size_t count) const
+        {
+            const size_t n  = lsp_min(count, nLeft);
+            if (n > 0)
+            {
+                const float end = (n < nLeft) ? fCurrent + fDelta * n : fTarget;
+                dsp::lramp2(dst, src, fCurrent, end, n);
+                if ((count -= n) <= 0)
+                    return;
+                dst            += n;
+                src            += n;
+            }
+
+            if (fTarget != 1.0f)
+                dsp::mul_k3(dst, src, fTarget, count);
+            else if (dst != src)
+                dsp::copy(dst, src, count);
+        }
+
+        void gain_smoother::apply_add(float *dst, const float *src, size_t count) const
+        {
+            const size_t n  = lsp_min(count, nLeft);
+            if (n > 0)
+            {
+                const float end = (n < nLeft) ? fCurrent + fDelta * n : fTarget;
+                dsp::lramp_add2(dst, src, fCurrent, end, n);
+                if ((count -= n) <= 0)
+                    return;
+                dst            += n;
+                src            += n;
+            }
+
+            if (fTarget != 1.0f)
+                dsp::fmadd_k3(dst, src, fTarget, count);
+            else
+                dsp::add2(dst, src, count);
+        }
+
+        void gain_smoother::advance(size_t count)
+        {
+            if (count < nLeft)
+            {
+                fCurrent       += fDelta * count;
+                nLeft          -= count;
+            }
+            else
+                reset(fTarget);
+        }
+
+        void gain_smoother::dump(dspu::IStateDumper *v) const
+        {
+            v->write("fCurrent", fCurrent);
+            v->write("fTarget", fTarget);
+            v->write("fDelta", fDelta);
+            v->write("nLeft", nLeft);
+            v->write("nLength", nLength);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -0,0 +1,427 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/common/endian.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/plugins/osc_listener.h>
+
+#ifdef PLATFORM_POSIX
+    #include <arpa/inet.h>
+    #include <errno.h>
+    #include <netinet/in.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif /* PLATFORM_POSIX */
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /* The period of checking the configuration by the listener thread in milliseconds */
+        static constexpr int        OSC_POLL_PERIOD     = 100;
+        /* The maximum size of the received packet */
+        static constexpr size_t     OSC_PACKET_SIZE     = 0x1000;
+        /* The maximum number of arguments of the message */
+        static constexpr size_t     OSC_MAX_ARGS        = 4;
+        /* The delay before the next attempt to start the listener thread in milliseconds */
+        static constexpr system::time_millis_t OSC_START_RETRY = 1000;
+
+        static constexpr uint32_t   OSC_CFG_ENABLED     = 1U << 31;
+        static constexpr uint32_t   OSC_CFG_ANY         = 1U << 30;
+
+        static const char *OSC_ADDR_SELECT              = "/ab_tester/sel";
+        static const char *OSC_ADDR_RATING              = "/ab_tester/rate";
+
+        //---------------------------------------------------------------------
+        osc_listener::Starter::Starter(osc_listener *listener)
+        {
+            pListener   = listener;
+        }
+
+        osc_listener::Starter::~Starter()
+        {
+            pListener   = NULL;
+        }
+
+        status_t osc_listener::Starter::run()
+        {
+            return pListener->do_start();
+        }
+
+        //---------------------------------------------------------------------
+        osc_listener::Listener::Listener(osc_listener *listener)
+        {
+            pListener   = listener;
+        }
+
+        osc_listener::Listener::~Listener()
+        {
+            pListener   = NULL;
+        }
+
+        status_t osc_listener::Listener::run()
+        {
+            return pListener->do_listen();
+        }
+
+        //---------------------------------------------------------------------
+        osc_listener::osc_listener():
+            sStarter(this)
+        {
+            pThread         = NULL;
+            vCommands       = NULL;
+            nCapacity       = 0;
+            nRetryTime      = 0;
+
+            atomic_store(&nHead, 0);
+            atomic_store(&nTail, 0);
+            atomic_store(&nDropped, 0);
+            atomic_store(&nConfig, 0);
+            atomic_store(&nStop, 0);
+        }
+
+        osc_listener::~osc_listener()
+        {
+            destroy();
+        }
+
+        status_t osc_listener::init(size_t capacity)
+        {
+            destroy();
+
+            // Round capacity to the power of two
+            size_t cap      = 1;
+            while (cap < capacity)
+                cap           <<= 1;
+
+            vCommands       = lsp::malloc<command_t>(cap);
+            if (vCommands == NULL)
+                return STATUS_NO_MEM;
+            nCapacity       = cap;
+
+            return STATUS_OK;
+        }
+
+        void osc_listener::destroy()
+        {
+            // Wait for the starter
+            while ((!sStarter.idle()) && (!sStarter.completed()))
+                ipc::Thread::sleep(10);
+            if (sStarter.completed())
+                sStarter.reset();
+
+            // Stop the listener thread
+            if (pThread != NULL)
+            {
+                atomic_store(&nStop, 1);
+                pThread->join();
+                delete pThread;
+                pThread         = NULL;
+            }
+
+            if (vCommands != NULL)
+            {
+                lsp::free(vCommands);
+                vCommands       = NULL;
+            }
+            nCapacity       = 0;
+            nRetryTime      = 0;
+
+            atomic_store(&nHead, 0);
+            atomic_store(&nTail, 0);
+            atomic_store(&nDropped, 0);
+            atomic_store(&nConfig, 0);
+            atomic_store(&nStop, 0);
+        }
+
+        void osc_listener::configure(bool enabled, bool any, uint16_t port)
+        {
+            uint32_t config = port;
+            if (enabled)
+                config         |= OSC_CFG_ENABLED;
+            if (any)
+                config         |= OSC_CFG_ANY;
+
+            atomic_store(&nConfig, config);
+        }
+
+        bool osc_listener::fetch(command_t *cmd)
+        {
+            size_t tail     = atomic_load(&nTail);
+            if (tail == atomic_load(&nHead))
+                return false;
+
+            *cmd            = vCommands[tail & (nCapacity - 1)];
+            atomic_store(&nTail, tail + 1);
+            return true;
+        }
+
+        bool osc_listener::push(uint32_t command, uint32_t channel, uint32_t value)
+        {
+            size_t head     = atomic_load(&nHead);
+            size_t tail     = atomic_load(&nTail);
+            if ((head - tail) >= nCapacity)
+            {
+                atomic_add(&nDropped, 1);
+                return false;
+            }
+
+            command_t *c    = &vCommands[head & (nCapacity - 1)];
+            c->nCommand     = command;
+            c->nChannel     = channel;
+            c->nValue       = value;
+            c->nPad         = 0;
+
+            atomic_store(&nHead, head + 1);
+            return true;
+        }
+
+        void osc_listener::submit(ipc::IExecutor *executor)
+        {
+            if ((executor == NULL) || (nCapacity <= 0))
+                return;
+
+            // The listener thread is launched once and then follows the configuration
+            if (sStarter.completed())
+            {
+                if (sStarter.successful())
+                    return;
+
+                // Retry the failed start after a delay
+                const system::time_millis_t now = system::get_time_millis();
+                if (nRetryTime == 0)
+                    nRetryTime          = now + OSC_START_RETRY;
+                if (now < nRetryTime)
+                    return;
+                sStarter.reset();
+            }
+            if ((sStarter.idle()) && (atomic_load(&nConfig) & OSC_CFG_ENABLED))
+            {
+                nRetryTime          = 0;
+                executor->submit(&sStarter);
+            }
+        }
+
+        status_t osc_listener::do_start()
+        {
+            if (pThread != NULL)
+                return STATUS_OK;
+
+            Listener *thread    = new Listener(this);
+            if (thread == NULL)
+                return STATUS_NO_MEM;
+
+            status_t res        = thread->start();
+            if (res != STATUS_OK)
+            {
+                lsp_warn("Could not start OSC listener thread, code=%d", int(res));
+                delete thread;
+                return res;
+            }
+
+            pThread             = thread;
+            return STATUS_OK;
+        }
+
+        status_t osc_listener::do_listen()
+        {
+        #ifdef PLATFORM_POSIX
+            uint8_t packet[OSC_PACKET_SIZE];
+            uint32_t config     = 0;
+            int fd              = -1;
+
+            while (!atomic_load(&nStop))
+            {
+                // Re-open the socket if the configuration has changed
+                uint32_t req        = atomic_load(&nConfig);
+                if (req != config)
+                {
+                    if (fd >= 0)
+                    {
+                        close(fd);
+                        fd                  = -1;
+                    }
+                    config              = req;
+
+                    if (config & OSC_CFG_ENABLED)
+                    {
+                        struct sockaddr_in addr;
+                        memset(&addr, 0, sizeof(addr));
+                        addr.sin_family         = AF_INET;
+                        addr.sin_port           = htons(config & 0xffff);
+                        addr.sin_addr.s_addr    = htonl((config & OSC_CFG_ANY) ? INADDR_ANY : INADDR_LOOPBACK);
+
+                        // The port is not shared: another instance listening on it would receive
+                        // only a part of datagrams, so the second instance fails to bind instead
+                        int error           = 0;
+                        fd                  = socket(AF_INET, SOCK_DGRAM, 0);
+                        if (fd < 0)
+                            error               = errno;
+                        else if (bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0)
+                        {
+                            error               = errno;
+                            close(fd);
+                            fd                  = -1;
+                        }
+                        if (fd < 0)
+                        {
+                            if (error == EADDRINUSE)
+                                lsp_warn("Could not open OSC socket: port %d is already in use", int(config & 0xffff));
+                            else
+                                lsp_warn("Could not open OSC socket on port %d, errno=%d", int(config & 0xffff), error);
+                        }
+                    }
+                }
+
+                if (fd < 0)
+                {
+                    ipc::Thread::sleep(OSC_POLL_PERIOD);
+                    continue;
+                }
+
+                // Wait for the packet
+                struct pollfd pfd;
+                pfd.fd              = fd;
+                pfd.events          = POLLIN;
+                pfd.revents         = 0;
+                if (poll(&pfd, 1, OSC_POLL_PERIOD) <= 0)
+                    continue;
+
+                ssize_t size        = recv(fd, packet, sizeof(packet), 0);
+                if (size > 0)
+                    parse_packet(packet, size);
+            }
+
+            if (fd >= 0)
+                close(fd);
+
+            return STATUS_OK;
+        #else
+            return STATUS_NOT_SUPPORTED;
+        #endif /* PLATFORM_POSIX */
+        }
+
+        static const char *read_string(const uint8_t * &data, const uint8_t *end)
+        {
+            const char *str     = reinterpret_cast<const char *>(data);
+            size_t len          = strnlen(str, end - data);
+            if (data + len >= end)
+                return NULL;
+
+            data               += (len + 4) & (~size_t(3));
+            return str;
+        }
+
+        static bool read_word(const uint8_t * &data, const uint8_t *end, uint32_t *word)
+        {
+            if (data + sizeof(uint32_t) > end)
+                return false;
+
+            uint32_t v;
+            memcpy(&v, data, sizeof(v));
+            *word               = BE_TO_CPU(v);
+            data               += sizeof(uint32_t);
+            return true;
+        }
+
+        void osc_listener::parse_packet(const uint8_t *data, size_t size)
+        {
+            const uint8_t *end  = &data[size];
+
+            // Process all elements of the bundle
+            if ((size >= 16) && (!memcmp(data, "#bundle", 8)))
+            {
+                data               += 16; // Skip tag and time tag
+                uint32_t length;
+                while (read_word(data, end, &length))
+                {
+                    if (length > size_t(end - data))
+                        return;
+                    parse_packet(data, length);
+                    data               += length;
+                }
+                return;
+            }
+
+            parse_message(data, size);
+        }
+
+        void osc_listener::parse_message(const uint8_t *data, size_t size)
+        {
+            const uint8_t *end  = &data[size];
+            const char *address = read_string(data, end);
+            const char *tags    = (address != NULL) ? read_string(data, end) : NULL;
+            if ((tags == NULL) || (tags[0] != ','))
+                return;
+
+            // Decode numeric arguments
+            uint32_t args[OSC_MAX_ARGS];
+            size_t nargs        = 0;
+            for (const char *t = &tags[1]; (*t != '\0') && (nargs < OSC_MAX_ARGS); ++t)
+            {
+                uint32_t word;
+                if (!read_word(data, end, &word))
+                    return;
+
+                if (*t == 'i')
+                    args[nargs++]       = int32_t(word) > 0 ? word : 0;
+                else if (*t == 'f')
+                {
+                    float value;
+                    memcpy(&value, &word, sizeof(value));
+                    args[nargs++]       = (value > 0.0f) ? uint32_t(lrintf(value)) : 0;
+                }
+                else
+                    return;
+            }
+
+            // Dispatch the message
+            if ((!strcmp(address, OSC_ADDR_SELECT)) && (nargs >= 1))
+                push(CMD_SELECT, 0, args[0]);
+            else if ((!strcmp(address, OSC_ADDR_RATING)) && (nargs >= 2))
+                push(CMD_RATING, args[0], args[1]);
+        }
+
+        size_t osc_listener::footprint() const
+        {
+            return nCapacity * sizeof(command_t);
+        }
+
+        void osc_listener::dump(dspu::IStateDumper *v) const
+        {
+            v->write("pThread", pThread);
+            v->write("vCommands", vCommands);
+            v->write("nCapacity", nCapacity);
+            v->write("nHead", size_t(atomic_load(&nHead)));
+            v->write("nTail", size_t(atomic_load(&nTail)));
+            v->write("nDropped", size_t(atomic_load(&nDropped)));
+            v->write("nConfig", size_t(atomic_load(&nConfig)));
+            v->write("nStop", size_t(atomic_load(&nStop)));
+            v->write("nRetryTime", nRetryTime);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
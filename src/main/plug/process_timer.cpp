@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/runtime/system.h>
+
+#include <private/plugins/process_timer.h>
+
+#ifdef PLATFORM_POSIX
+    #include <time.h>
+#endif /* PLATFORM_POSIX */
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /* The length of the load measurement window in seconds */
+        static constexpr float LOAD_WINDOW_LEN  = 0.5f;
+
+        uint64_t process_timer::now()
+        {
+        #ifdef PLATFORM_POSIX
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+        #else
+            return uint64_t(system::get_time_millis()) * 1000000ULL;
+        #endif /* PLATFORM_POSIX */
+        }
+
+        process_timer::process_timer()
+        {
+            nSampleRate     = 0;
+            nWindow         = 0;
+            reset();
+        }
+
+        process_timer::~process_timer()
+        {
+        }
+
+        void process_timer::reset()
+        {
+            nCalls          = 0;
+            nSamples        = 0;
+            nTime           = 0;
+            nWorst          = 0;
+            nWorstSamples   = 0;
+            for (size_t i=0; i<STAGE_TOTAL; ++i)
+                vStages[i]      = 0;
+            nStageSamples   = 0;
+            nStart          = 0;
+            nMark           = 0;
+            bStages         = false;
+
+            nWinTime        = 0;
+            nWinSamples     = 0;
+            fWinPeak        = 0.0f;
+            fLoad           = 0.0f;
+            fPeak           = 0.0f;
+        }
+
+        void process_timer::set_sample_rate(size_t sr)
+        {
+            nSampleRate     = sr;
+            nWindow         = size_t(sr * LOAD_WINDOW_LEN);
+            nWinTime        = 0;
+            nWinSamples     = 0;
+            fWinPeak        = 0.0f;
+        }
+
+        void process_timer::end(size_t samples)
+        {
+            const uint64_t time = now() - nStart;
+
+            ++nCalls;
+            nSamples       += samples;
+            nTime          += time;
+            if (time > nWorst)
+            {
+                nWorst          = time;
+                nWorstSamples   = samples;
+            }
+            if (bStages)
+                nStageSamples  += samples;
+
+            // Update the load measurement window
+            if ((samples <= 0) || (nSampleRate <= 0))
+                return;
+
+            const float budget  = float(samples) * 1e+9f / float(nSampleRate);
+            const float load    = float(time) * 100.0f / budget;
+            if (load > fWinPeak)
+                fWinPeak        = load;
+            nWinTime       += time;
+            nWinSamples    += samples;
+            if (nWinSamples < nWindow)
+                return;
+
+            fLoad           = float(nWinTime) * float(nSampleRate) * 1e-7f / float(nWinSamples);
+            fPeak           = fWinPeak;
+            nWinTime        = 0;
+            nWinSamples     = 0;
+            fWinPeak        = 0.0f;
+        }
+
+        void process_timer::dump(dspu::IStateDumper *v) const
+        {
+            v->write("nCalls", nCalls);
+            v->write("nSamples", nSamples);
+            v->write("nTime", nTime);
+            v->write("nWorst", nWorst);
+            v->write("nWorstSamples", nWorstSamples);
+            v->writev("vStages", vStages, STAGE_TOTAL);
+            v->write("nStageSamples", nStageSamples);
+            v->write("nStart", nStart);
+            v->write("nMark", nMark);
+            v->write("bStages", bStages);
+            v->write("nSampleRate", nSampleRate);
+            v->write("nWindow", nWindow);
+            v->write("nWinTime", nWinTime);
+            v->write("nWinSamples", nWinSamples);
+            v->write("fWinPeak", fWinPeak);
+            v->write("fLoad", fLoad);
+            v->write("fPeak", fPeak);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/ipc/Thread.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/plugins/trial_journal.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /* The delay before the next attempt to open the journal file, ms */
+        static constexpr system::time_millis_t OPEN_RETRY_DELAY    = 1000;
+
+        static const char *journal_events[] =
+        {
+            "start",
+            "select",
+            "rating",
+            "blind",
+            "shuffle"
+        };
+
+        //---------------------------------------------------------------------
+        trial_journal::Writer::Writer(trial_journal *journal)
+        {
+            pJournal    = journal;
+        }
+
+        trial_journal::Writer::~Writer()
+        {
+            pJournal    = NULL;
+        }
+
+        status_t trial_journal::Writer::run()
+        {
+            return pJournal->do_write();
+        }
+
+        //---------------------------------------------------------------------
+        trial_journal::trial_journal():
+            sWriter(this)
+        {
+            vRecords        = NULL;
+            nCapacity       = 0;
+            hFile           = NULL;
+            nRetryTime      = 0;
+            bOpenFailed     = false;
+            sPath[0]        = '\0';
+
+            atomic_store(&nHead, 0);
+            atomic_store(&nTail, 0);
+            atomic_store(&nDropped, 0);
+            atomic_store(&nNewPath, 0);
+            atomic_store(&nOpened, 0);
+        }
+
+        trial_journal::~trial_journal()
+        {
+            destroy();
+        }
+
+        status_t trial_journal::init(size_t capacity)
+        {
+            destroy();
+
+            // Round capacity to the power of two
+            size_t cap      = 1;
+            while (cap < capacity)
+                cap           <<= 1;
+
+            vRecords        = lsp::malloc<record_t>(cap);
+            if (vRecords == NULL)
+                return STATUS_NO_MEM;
+            nCapacity       = cap;
+
+            return STATUS_OK;
+        }
+
+        void trial_journal::destroy()
+        {
+            // Wait for the writer and write the rest of records
+            while ((!sWriter.idle()) && (!sWriter.completed()))
+                ipc::Thread::sleep(10);
+            if (sWriter.completed())
+                sWriter.reset();
+            if (vRecords != NULL)
+                do_write();
+
+            if (hFile != NULL)
+            {
+                fclose(hFile);
+                hFile           = NULL;
+            }
+            atomic_store(&nOpened, 0);
+            if (vRecords != NULL)
+            {
+                lsp::free(vRecords);
+                vRecords        = NULL;
+            }
+            nCapacity       = 0;
+
+            atomic_store(&nHead, 0);
+            atomic_store(&nTail, 0);
+            atomic_store(&nDropped, 0);
+        }
+
+        bool trial_journal::idle() const
+        {
+            return sWriter.idle();
+        }
+
+        void trial_journal::set_path(const char *path)
+        {
+            strncpy(sPath, path, sizeof(sPath));
+            sPath[sizeof(sPath) - 1] = '\0';
+            nRetryTime      = 0;
+            bOpenFailed     = false;
+            atomic_store(&nNewPath, 1);
+        }
+
+        bool trial_journal::push(uint64_t position, event_t event, uint32_t channel, uint32_t value)
+        {
+            if (nCapacity <= 0)
+                return false;
+
+            size_t head     = atomic_load(&nHead);
+            size_t tail     = atomic_load(&nTail);
+            if ((head - tail) >= nCapacity)
+            {
+                atomic_add(&nDropped, 1);
+                return false;
+            }
+
+            record_t *r     = &vRecords[head & (nCapacity - 1)];
+            r->nPosition    = position;
+            r->nEvent       = event;
+            r->nChannel     = channel;
+            r->nValue       = value;
+            r->nPad         = 0;
+
+            atomic_store(&nHead, head + 1);
+            return true;
+        }
+
+        void trial_journal::submit(ipc::IExecutor *executor)
+        {
+            if (executor == NULL)
+                return;
+
+            const bool pending  = atomic_load(&nNewPath);
+            if (sWriter.completed())
+            {
+                // The file could not be opened, postpone the next attempt
+                if ((pending) && (!sWriter.successful()))
+                    nRetryTime          = system::get_time_millis() + OPEN_RETRY_DELAY;
+                sWriter.reset();
+            }
+            if (!sWriter.idle())
+                return;
+
+            // Records are kept in the queue until the file is open
+            if (pending)
+            {
+                if ((nRetryTime > 0) && (system::get_time_millis() < nRetryTime))
+                    return;
+                nRetryTime          = 0;
+                executor->submit(&sWriter);
+            }
+            else if ((atomic_load(&nOpened)) && (atomic_load(&nHead) != atomic_load(&nTail)))
+                executor->submit(&sWriter);
+        }
+
+        void trial_journal::write_record(const record_t *r)
+        {
+            const char *event   = (r->nEvent < (sizeof(journal_events) / sizeof(const char *))) ?
+                                  journal_events[r->nEvent] : "unknown";
+
+            if (r->nEvent == EV_SHUFFLE)
+                fprintf(hFile, "%llu,%s,%d,0x%08x\n",
+                    (unsigned long long)r->nPosition, event, int(r->nChannel), int(r->nValue));
+            else
+                fprintf(hFile, "%llu,%s,%d,%d\n",
+                    (unsigned long long)r->nPosition, event, int(r->nChannel), int(r->nValue));
+        }
+
+        status_t trial_journal::do_write()
+        {
+            // Re-open the journal file if the path has changed
+            if (atomic_load(&nNewPath))
+            {
+                if (hFile != NULL)
+                {
+                    atomic_store(&nOpened, 0);
+                    fclose(hFile);
+                    hFile           = NULL;
+                }
+
+                if (strlen(sPath) > 0)
+                {
+                    hFile           = fopen(sPath, "a");
+                    if (hFile == NULL)
+                    {
+                        // Keep the path pending, records stay in the queue till the next attempt
+                        if (!bOpenFailed)
+                            lsp_warn("Could not open journal file %s", sPath);
+                        bOpenFailed     = true;
+                        return STATUS_IO_ERROR;
+                    }
+
+                    // Write the header for the new file
+                    if (ftell(hFile) == 0)
+                        fprintf(hFile, "position,event,channel,value\n");
+                    atomic_store(&nOpened, 1);
+                }
+                bOpenFailed     = false;
+                atomic_store(&nNewPath, 0);
+            }
+
+            // Records are written only to the open file, otherwise they are dropped by push() on overflow
+            if (hFile == NULL)
+                return STATUS_OK;
+
+            // Write all pending records
+            size_t tail     = atomic_load(&nTail);
+            size_t head     = atomic_load(&nHead);
+            for (size_t i=tail; i != head; ++i)
+                write_record(&vRecords[i & (nCapacity - 1)]);
+
+            size_t dropped  = atomic_swap(&nDropped, 0);
+            if (dropped > 0)
+                fprintf(hFile, "# %d records dropped\n", int(dropped));
+
+            fflush(hFile);
+            atomic_store(&nTail, head);
+
+            return STATUS_OK;
+        }
+
+        size_t trial_journal::footprint() const
+        {
+            return nCapacity * sizeof(record_t);
+        }
+
+        void trial_journal::dump(dspu::IStateDumper *v) const
+        {
+            v->write("vRecords", vRecords);
+            v->write("nCapacity", nCapacity);
+            v->write("nHead", size_t(atomic_load(&nHead)));
+            v->write("nTail", size_t(atomic_load(&nTail)));
+            v->write("nDropped", size_t(atomic_load(&nDropped)));
+            v->write("nNewPath", size_t(atomic_load(&nNewPath)));
+            v->write("nOpened", size_t(atomic_load(&nOpened)));
+            v->write("hFile", hFile);
+            v->write("nRetryTime", nRetryTime);
+            v->write("bOpenFailed", bOpenFailed);
+            v->write("sPath", sPath);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
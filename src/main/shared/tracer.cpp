@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/shared/tracer.h>
+
+#ifdef LSP_AB_TESTER_TRACE
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/runtime/system.h>
+
+#include <pthread.h>
+#include <time.h>
+
+namespace lsp
+{
+    namespace tracer
+    {
+        /* The maximum number of traced threads */
+        static constexpr size_t MAX_THREADS     = 16;
+        /* The number of events in the ring buffer of each thread, power of two */
+        static constexpr size_t RING_SIZE       = 0x4000;
+
+        typedef struct event_t
+        {
+            const char         *name;       // Name of the event
+            uint64_t            start;      // Start time, ns
+            uint64_t            end;        // End time, ns
+        } event_t;
+
+        typedef struct ring_t
+        {
+            uatomic_t           owned;      // The ring is owned by the running thread
+            uatomic_t           head;       // Number of recorded events
+            event_t             events[RING_SIZE];
+        } ring_t;
+
+        // Rings are pre-allocated, so recording never allocates memory. Thread-local
+        // variables are trivially destructible, so the first event of the thread does not
+        // register the TLS destructor. The ring is released by the destructor of the
+        // thread-specific key that is created by the first attached instance.
+        static ring_t           rings[MAX_THREADS];
+        static uatomic_t        nrings      = 0;
+        static uatomic_t        instances   = 0;
+        static pthread_once_t   key_once    = PTHREAD_ONCE_INIT;
+        static pthread_key_t    key;
+        static uatomic_t        key_ready   = 0;
+        static thread_local ring_t *local   = NULL;
+        static thread_local bool overflow   = false;
+
+        static void release_ring(void *ptr)
+        {
+            ring_t *r           = static_cast<ring_t *>(ptr);
+            atomic_store(&r->owned, 0);
+        }
+
+        static void create_key()
+        {
+            if (pthread_key_create(&key, release_ring) == 0)
+                atomic_store(&key_ready, 1);
+        }
+
+        static ring_t *thread_ring()
+        {
+            if ((local != NULL) || (overflow))
+                return local;
+            if (!atomic_load(&key_ready))
+                return NULL;
+
+            // Take the first free ring, the new thread appends its events after the
+            // events of the exited thread
+            for (size_t i=0; i<MAX_THREADS; ++i)
+            {
+                ring_t *r           = &rings[i];
+                if (!atomic_cas(&r->owned, 0, 1))
+                    continue;
+
+                // The ring is released when the thread exits
+                if (pthread_setspecific(key, r) != 0)
+                {
+                    atomic_store(&r->owned, 0);
+                    overflow            = true;
+                    return NULL;
+                }
+
+                // Extend the number of exported rings
+                uatomic_t count     = atomic_load(&nrings);
+                while ((count <= i) && (!atomic_cas(&nrings, count, i + 1)))
+                    count               = atomic_load(&nrings);
+
+                local               = r;
+                return r;
+            }
+
+            overflow            = true;
+            return NULL;
+        }
+
+        uint64_t now()
+        {
+        #ifdef PLATFORM_POSIX
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+        #else
+            return uint64_t(system::get_time_millis()) * 1000000ULL;
+        #endif /* PLATFORM_POSIX */
+        }
+
+        scope::scope(const char *name)
+        {
+            pName       = name;
+            nStart      = now();
+        }
+
+        scope::~scope()
+        {
+            record(pName, nStart, now());
+        }
+
+        void record(const char *name, uint64_t start, uint64_t end)
+        {
+            ring_t *r           = thread_ring();
+            if (r == NULL)
+                return;
+
+            size_t head         = atomic_load(&r->head);
+            event_t *ev         = &r->events[head & (RING_SIZE - 1)];
+            ev->name            = name;
+            ev->start           = start;
+            ev->end             = end;
+            atomic_store(&r->head, head + 1);
+        }
+
+        void attach()
+        {
+            pthread_once(&key_once, create_key);
+            atomic_add(&instances, 1);
+        }
+
+        void detach(const char *suffix)
+        {
+            // Only the last instance exports the trace, so instances do not overwrite each other
+            if (atomic_add(&instances, -1) != 1)
+                return;
+
+            const char *base    = getenv("LSP_AB_TESTER_TRACE_FILE");
+            if (base == NULL)
+                return;
+
+            char path[PATH_MAX];
+            snprintf(path, sizeof(path), "%s%s", base, suffix);
+            if (export_chrome(path) != STATUS_OK)
+                lsp_warn("Could not export trace to %s", path);
+        }
+
+        status_t export_chrome(const char *path)
+        {
+            FILE *fd            = fopen(path, "w");
+            if (fd == NULL)
+                return STATUS_IO_ERROR;
+
+            fprintf(fd, "{\"traceEvents\":[\n");
+
+            bool first          = true;
+            const size_t threads    = atomic_load(&nrings);
+
+            for (size_t i=0; i<threads; ++i)
+            {
+                // Events are exported as is, the thread may still record events
+                const ring_t *r     = &rings[i];
+                size_t head         = atomic_load(&r->head);
+                size_t count        = (head > RING_SIZE) ? RING_SIZE : head;
+
+                for (size_t j=head - count; j<head; ++j)
+                {
+                    const event_t *ev   = &r->events[j & (RING_SIZE - 1)];
+                    fprintf(fd, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                        (first) ? "" : ",\n",
+                        ev->name, int(i + 1),
+                        ev->start * 1e-3, (ev->end - ev->start) * 1e-3);
+                    first               = false;
+                }
+            }
+
+            fprintf(fd, "\n],\"displayTimeUnit\":\"ns\"}\n");
+
+            status_t res        = (ferror(fd)) ? STATUS_IO_ERROR : STATUS_OK;
+            if (fclose(fd) != 0)
+                res                 = STATUS_IO_ERROR;
+
+            return res;
+        }
+
+    } /* namespace tracer */
+} /* namespace lsp */
+
+#endif /* LSP_AB_TESTER_TRACE */
@@ -25,7 +25,8 @@
 #include <lsp-plug.in/stdlib/stdio.h>
 #include <lsp-plug.in/stdlib/string.h>
 
-#include <private/plugins/ab_tester.h>
+#include <private/meta/ab_tester.h>
+#include <private/shared/tracer.h>
 #include <private/ui/ab_tester.h>
 
 namespace lsp
@@ -53,6 +54,11 @@ namespace lsp
 
         //---------------------------------------------------------------------
         static const char *KVT_SHUFFLE_INDICES = "/shuffle_indices";
+        static const char *KVT_CHANNEL_NAMES   = "/channel_names";
+        static const char *KVT_REMOTE_STATE    = "/remote_state";
+
+        // Delay after the last edit of the channel name before it is submitted to KVT, ms
+        static constexpr system::time_millis_t NAME_SYNC_DELAY  = 250;
 
         //---------------------------------------------------------------------
         // A/B tester UI
@@ -74,14 +80,31 @@ namespace lsp
             pReset          = NULL;
             pShuffle        = NULL;
             pBlindTest      = NULL;
+            pMono           = NULL;
+            pInputs         = NULL;
 
             wBlindGrid      = NULL;
             wSelectAll      = NULL;
             wSelectNone     = NULL;
+
+            nPortMask       = 0;
+            nNameDeadline   = 0;
+            nLegacyNames    = 0;
+            nCreateTime     = system::get_time_millis();
+            bBlindView      = false;
+            bNamesBlob      = false;
+            bRemoteApply    = false;
+
+        #ifdef LSP_AB_TESTER_TRACE
+            tracer::attach();
+        #endif /* LSP_AB_TESTER_TRACE */
         }
 
         ab_tester_ui::~ab_tester_ui()
         {
+        #ifdef LSP_AB_TESTER_TRACE
+            tracer::detach(".ui");
+        #endif /* LSP_AB_TESTER_TRACE */
         }
 
         void ab_tester_ui::destroy()
@@ -96,6 +119,25 @@ namespace lsp
                     delete c;
             }
             vChannels.flush();
+            vShuffled.flush();
+            vGridOrder.flush();
+            vDirtyNames.flush();
+            vPortMap.flush();
+            nPortMask       = 0;
+        }
+
+        tk::Widget *ab_tester_ui::find_widget(const char *prefix, size_t index)
+        {
+            char id[0x40];
+            snprintf(id, sizeof(id), "%s_%d", prefix, int(index));
+            return pWrapper->controller()->widgets()->find(id);
+        }
+
+        ui::IPort *ab_tester_ui::find_port(const char *prefix, size_t index)
+        {
+            char id[0x40];
+            snprintf(id, sizeof(id), "%s_%d", prefix, int(index));
+            return pWrapper->port(id);
         }
 
         ab_tester_ui::channel_t *ab_tester_ui::create_channel(size_t channel_id)
@@ -104,38 +146,29 @@ namespace lsp
             if (c == NULL)
                 return NULL;
 
-            LSPString id;
-            tk::Registry *reg = pWrapper->controller()->widgets();
+            c->pUI              = this;
             c->nIndex           = channel_id + 1;
-            c->nRandom          = 0;
 
-            // Bind rating buttons
-            for (size_t i=meta::ab_tester::RATE_MIN; i<=meta::ab_tester::RATE_MAX; i += meta::ab_tester::RATE_STEP)
-            {
-                // Find button widget for rating
-                for (size_t j=0; j<2; ++j)
-                {
-                    id.fmt_ascii("%s_%d_%d",
-                        (j == 0) ? "rating" : "bte_rating",
-                        int(c->nIndex), int(i));
-                    tk::Button *btn = reg->get<tk::Button>(&id);
-                    if (btn != NULL)
-                    {
-                        c->vRating[j].vButtons.add(btn);
-                        btn->slots()->bind(tk::SLOT_CHANGE, slot_rating_button_change, c);
-                    }
-                }
-            }
-            id.fmt_ascii("rate_%d", int(c->nIndex));
-            c->pRating  = pWrapper->port(&id);
+            // Widgets of the blind test view are resolved when the view is shown first time
+            c->vRating[0]       = create_rating("rating", c->nIndex);
+            c->vRating[1]       = NULL;
+            if (c->vRating[0] != NULL)
+                c->vRating[0]->slots()->bind(tk::SLOT_CHANGE, slot_rating_change, c);
+
+            c->wBlindLabel      = NULL;
+            c->wBlindRating     = NULL;
+            c->wBlindSelector   = NULL;
+            c->wBlindSeparator  = NULL;
+
+            c->pRating          = find_port("rate", c->nIndex);
             if (c->pRating != NULL)
                 c->pRating->bind(this);
 
-            id.fmt_ascii("bte_%d", int(c->nIndex));
-            c->pEnable = pWrapper->port(&id);
+            c->pEnable          = find_port("bte", c->nIndex);
+            if (c->pEnable != NULL)
+                c->pEnable->bind(this);
 
-            id.fmt_ascii("channel_label_%d", int(c->nIndex));
-            c->wName            = reg->get<tk::Edit>(&id);
+            c->wName            = tk::widget_cast<tk::Edit>(find_widget("channel_label", c->nIndex));
             if (c->wName != NULL)
             {
                 c->wName->text()->set("lists.ab_tester.instance");
@@ -145,20 +178,90 @@ namespace lsp
             }
             c->bNameChanged     = false;
 
-            id.fmt_ascii("bte_label_%d", int(c->nIndex));
-            c->wBlindLabel      = reg->get<tk::Label>(&id);
-            id.fmt_ascii("bte_rating_%d", int(c->nIndex));
-            c->wBlindRating     = reg->find(&id);
-            id.fmt_ascii("bte_selector_%d", int(c->nIndex));
-            c->wBlindSelector   = reg->find(&id);
-            id.fmt_ascii("bte_separator_%d", int(c->nIndex));
-            c->wBlindSeparator  = reg->find(&id);
-
             return c;
         }
 
+        tk::RatingBar *ab_tester_ui::create_rating(const char *prefix, size_t index)
+        {
+            // The rating bar is placed into the container defined by the UI layout
+            tk::Box *box        = tk::widget_cast<tk::Box>(find_widget(prefix, index));
+            if (box == NULL)
+                return NULL;
+
+            tk::Registry *reg   = pWrapper->controller()->widgets();
+            tk::RatingBar *bar  = new tk::RatingBar(pWrapper->display());
+            if (bar == NULL)
+                return NULL;
+            if ((bar->init() != STATUS_OK) || (reg->add(bar) != STATUS_OK))
+            {
+                bar->destroy();
+                delete bar;
+                return NULL;
+            }
+
+            bar->levels()->set((meta::ab_tester::RATE_MAX - meta::ab_tester::RATE_MIN) / meta::ab_tester::RATE_STEP + 1);
+            bar->allocation()->set_hexpand(true);
+            bar->allocation()->set_hfill(true);
+
+            // Apply colors of the schema
+            tk::Schema *schema  = pWrapper->display()->schema();
+            const lsp::Color *c = NULL;
+            if ((c = schema->color("bg_schema")) != NULL)
+                bar->bg_color()->set(c);
+            if ((c = schema->color("button_cyan_rating_color")) != NULL)
+                bar->color()->set(c);
+            if ((c = schema->color("button_cyan_rating_border_color")) != NULL)
+                bar->border_color()->set(c);
+            if ((c = schema->color("button_cyan_rating_down_color")) != NULL)
+                bar->down_color()->set(c);
+            if ((c = schema->color("button_cyan_rating_down_border_color")) != NULL)
+                bar->down_border_color()->set(c);
+            if ((c = schema->color("button_inactive")) != NULL)
+                bar->inactive_color()->set(c);
+            if ((c = schema->color("button_inactive_border")) != NULL)
+                bar->inactive_border_color()->set(c);
+
+            box->add(bar);
+
+            return bar;
+        }
+
+        status_t ab_tester_ui::build_blind_view()
+        {
+            if (bBlindView)
+                return STATUS_OK;
+
+            const system::time_millis_t start = system::get_time_millis();
+
+            // Resolve widgets of all channels in one pass
+            wBlindGrid              = pWrapper->controller()->widgets()->get<tk::Grid>("bte_grid");
+            for (size_t i=0, n=vChannels.size(); i<n; ++i)
+            {
+                channel_t *c            = vChannels.uget(i);
+
+                c->wBlindLabel          = tk::widget_cast<tk::Label>(find_widget("bte_label", c->nIndex));
+                c->wBlindRating         = find_widget("bte_rating", c->nIndex);
+                c->wBlindSelector       = find_widget("bte_selector", c->nIndex);
+                c->wBlindSeparator      = find_widget("bte_separator", c->nIndex);
+
+                c->vRating[1]           = create_rating("bte_rating_bar", c->nIndex);
+                if (c->vRating[1] != NULL)
+                    c->vRating[1]->slots()->bind(tk::SLOT_CHANGE, slot_rating_change, c);
+                update_rating(c);
+            }
+            bBlindView              = true;
+
+            // Apply the shuffle state that could be received before
+            update_blind_grid();
+
+            lsp_trace("Blind test view built in %d ms", int(system::get_time_millis() - start));
+
+            return STATUS_OK;
+        }
+
         status_t ab_tester_ui::post_init()
         {
+            const system::time_millis_t start = system::get_time_millis();
             status_t res = ui::Module::post_init();
             if (res != STATUS_OK)
                 return res;
@@ -177,10 +280,21 @@ namespace lsp
                 }
             }
 
+            sNames.clear(vChannels.size());
+
+            // Initially the blind grid contains all channels in the natural order
+            for (size_t i=0, n=vChannels.size(); i<n; ++i)
+            {
+                if (!vGridOrder.add(vChannels.uget(i)))
+                    return STATUS_NO_MEM;
+            }
+
             tk::Registry *reg = pWrapper->controller()->widgets();
 
             // Bind events
             pSelector               = pWrapper->port("sel");
+            if (pSelector != NULL)
+                pSelector->bind(this);
 
             pReset                  = pWrapper->port("rst");
             if (pReset != NULL)
@@ -194,7 +308,8 @@ namespace lsp
             if (pBlindTest != NULL)
                 pBlindTest->bind(this);
 
-            wBlindGrid              = reg->get<tk::Grid>("bte_grid");
+            pMono                   = pWrapper->port("mono");
+            pInputs                 = pWrapper->port("inputs");
 
             wSelectAll              = reg->get<tk::Button>("select_all");
             if (wSelectAll != NULL)
@@ -203,37 +318,153 @@ namespace lsp
             if (wSelectNone != NULL)
                 wSelectNone->slots()->bind(tk::SLOT_CHANGE, slot_select_updated, this);
 
+            if (!build_port_map())
+                return STATUS_NO_MEM;
+
+            // Sync rating bars with the actual state
+            for (size_t i=0, n=vChannels.size(); i<n; ++i)
+                update_rating(vChannels.uget(i));
+            update_active();
+
+            // The blind test view is built on demand
+            if ((pBlindTest != NULL) && (pBlindTest->value() >= 0.5f))
+            {
+                if ((res = build_blind_view()) != STATUS_OK)
+                    return res;
+            }
+
+            // Report the time of the editor startup
+            const system::time_millis_t end = system::get_time_millis();
+            lsp_trace("%s editor opened in %d ms, post-initialized in %d ms",
+                pMetadata->uid, int(end - nCreateTime), int(end - start));
+
             return STATUS_OK;
         }
 
-        void ab_tester_ui::notify(ui::IPort *port, size_t flags)
+        inline size_t ab_tester_ui::port_hash(const ui::IPort *port)
         {
-            if (port == pBlindTest)
-            {
-                if (pBlindTest->value() >= 0.5f)
-                    blind_test_enable();
-            }
+            // Fibonacci hashing of the pointer, lower bits are always zero due to alignment
+            const uint64_t key = uint64_t(reinterpret_cast<uintptr_t>(port)) >> 3;
+            return size_t((key * 0x9e3779b97f4a7c15ULL) >> 32);
+        }
+
+        bool ab_tester_ui::add_port_binding(ui::IPort *port, port_handler_t handler, channel_t *ch)
+        {
+            if (port == NULL)
+                return true;
 
-            if (port == pReset)
+            for (size_t i=port_hash(port); ; ++i)
             {
-                if (pReset->value() >= 0.5f)
-                    reset_ratings();
+                port_binding_t *b   = vPortMap.uget(i & nPortMask);
+                if (b->pPort == port)
+                    return false;
+                if (b->pPort != NULL)
+                    continue;
+
+                b->pPort            = port;
+                b->nHandler         = handler;
+                b->pChannel         = ch;
+                return true;
             }
+        }
 
-            if (port == pShuffle)
+        bool ab_tester_ui::build_port_map()
+        {
+            // The table is kept at most half-full, so probe sequences remain short
+            size_t count    = 4 + vChannels.size() * 2;
+            size_t cap      = 1;
+            while (cap < count * 2)
+                cap           <<= 1;
+
+            vPortMap.clear();
+            port_binding_t *v = vPortMap.add_n(cap);
+            if (v == NULL)
+                return false;
+            for (size_t i=0; i<cap; ++i)
             {
-                if (pShuffle->value() >= 0.5f)
-                    shuffle_data();
+                v[i].pPort      = NULL;
+                v[i].nHandler   = PH_RATING;
+                v[i].pChannel   = NULL;
             }
+            nPortMask       = cap - 1;
 
+            // Each port is bound to a single handler
+            add_port_binding(pBlindTest, PH_BLIND_TEST, NULL);
+            add_port_binding(pSelector, PH_SELECTOR, NULL);
+            add_port_binding(pReset, PH_RESET, NULL);
+            add_port_binding(pShuffle, PH_SHUFFLE, NULL);
             for (size_t i=0, n=vChannels.size(); i<n; ++i)
             {
                 channel_t *c = vChannels.uget(i);
                 if (c == NULL)
                     continue;
+                add_port_binding(c->pRating, PH_RATING, c);
+                add_port_binding(c->pEnable, PH_ENABLE, c);
+            }
+
+            return true;
+        }
+
+        const ab_tester_ui::port_binding_t *ab_tester_ui::find_port_binding(const ui::IPort *port) const
+        {
+            if (vPortMap.size() <= 0)
+                return NULL;
+
+            for (size_t i=port_hash(port); ; ++i)
+            {
+                const port_binding_t *b = vPortMap.uget(i & nPortMask);
+                if (b->pPort == port)
+                    return b;
+                if (b->pPort == NULL)
+                    return NULL;
+            }
+        }
+
+        void ab_tester_ui::notify(ui::IPort *port, size_t flags)
+        {
+            AB_TRACE_SCOPE("ui.notify");
+
+            const port_binding_t *b = find_port_binding(port);
+            if (b == NULL)
+                return;
+
+            switch (b->nHandler)
+            {
+                case PH_BLIND_TEST:
+                    if (pBlindTest->value() >= 0.5f)
+                    {
+                        // The plugin has already entered the blind test when it was enabled by MIDI
+                        // or OSC, the ratings and the selector are kept then
+                        build_blind_view();
+                        if (!bRemoteApply)
+                            blind_test_enable();
+                    }
+                    break;
+
+                case PH_SELECTOR:
+                    update_active();
+                    break;
+
+                case PH_RESET:
+                    if (pReset->value() >= 0.5f)
+                        reset_ratings();
+                    break;
+
+                case PH_SHUFFLE:
+                    if (pShuffle->value() >= 0.5f)
+                        restart_blind_test();
+                    break;
+
+                case PH_RATING:
+                    update_rating(b->pChannel);
+                    break;
+
+                case PH_ENABLE:
+                    update_active();
+                    break;
 
-                if (c->pRating == port)
-                    update_rating(c);
+                default:
+                    break;
             }
         }
 
@@ -242,51 +473,48 @@ namespace lsp
             if (ch->pRating == NULL)
                 return;
 
-            size_t value = ch->pRating->value();
-
+            const ssize_t value = (ssize_t(ch->pRating->value()) - ssize_t(meta::ab_tester::RATE_MIN)) / ssize_t(meta::ab_tester::RATE_STEP) + 1;
             for (size_t j=0; j<2; ++j)
             {
-                rating_t *r = &ch->vRating[j];
-                size_t max  = meta::ab_tester::RATE_MIN;
+                if (ch->vRating[j] != NULL)
+                    ch->vRating[j]->value()->set(value);
+            }
+        }
 
-                for (size_t i=0, n=r->vButtons.size(); i<n; ++i, max += meta::ab_tester::RATE_STEP)
-                {
-                    tk::Button *btn = r->vButtons.uget(i);
-                    if (btn == NULL)
-                        continue;
+        void ab_tester_ui::update_active()
+        {
+            // The rating of the channel is highlighted when the channel is selected or participates in the blind test
+            const size_t selector   = (pSelector != NULL) ? size_t(pSelector->value()) : 0;
+            const bool all          = vChannels.size() <= 2;
 
-                    btn->down()->set(max <= value);
-                }
+            for (size_t i=0, n=vChannels.size(); i<n; ++i)
+            {
+                channel_t *c            = vChannels.uget(i);
+                tk::RatingBar *bar      = (c != NULL) ? c->vRating[0] : NULL;
+                if (bar == NULL)
+                    continue;
+
+                const bool enabled      = (c->pEnable != NULL) && (c->pEnable->value() >= 0.5f);
+                const bool active       = (all) || (enabled) || (c->nIndex == selector);
+                bar->active()->set(active);
+                bar->brightness()->set((active) ? 1.0f : 0.75f);
             }
         }
 
-        status_t ab_tester_ui::slot_rating_button_change(tk::Widget *sender, void *ptr, void *data)
+        status_t ab_tester_ui::slot_rating_change(tk::Widget *sender, void *ptr, void *data)
         {
-            tk::Button *btn = tk::widget_cast<tk::Button>(sender);
-            if (btn == NULL)
+            tk::RatingBar *bar = tk::widget_cast<tk::RatingBar>(sender);
+            if (bar == NULL)
                 return STATUS_OK;
 
             channel_t *c = static_cast<channel_t *>(ptr);
             if (c->pRating == NULL)
                 return STATUS_OK;
 
-            // Update port value
-            for (size_t j=0; j<2; ++j)
-            {
-                rating_t *r = &c->vRating[j];
-                size_t max  = meta::ab_tester::RATE_MIN;
-
-                for (size_t i=0, n=r->vButtons.size(); i<n; ++i, max +=  meta::ab_tester::RATE_STEP)
-                {
-                    tk::Button *rate_btn = r->vButtons.uget(i);
-                    if (btn == rate_btn)
-                    {
-                        c->pRating->set_value(max);
-                        c->pRating->notify_all(ui::PORT_USER_EDIT);
-                        break;
-                    }
-                }
-            }
+            // Update port value, the other rating bar is synchronized on notification
+            const ssize_t level = lsp_max(bar->value()->get(), ssize_t(1));
+            c->pRating->set_value(meta::ab_tester::RATE_MIN + (level - 1) * meta::ab_tester::RATE_STEP);
+            c->pRating->notify_all(ui::PORT_USER_EDIT);
 
             return STATUS_OK;
         }
@@ -294,52 +522,89 @@ namespace lsp
         status_t ab_tester_ui::slot_channel_name_updated(tk::Widget *sender, void *ptr, void *data)
         {
             channel_t *c    = static_cast<channel_t *>(ptr);
-            c->bNameChanged = true;
+            c->pUI->channel_name_changed(c);
 
             return STATUS_OK;
         }
 
-        void ab_tester_ui::set_channel_name(core::KVTStorage *kvt, int id, const char *name)
+        void ab_tester_ui::channel_name_changed(channel_t *ch)
+        {
+            // Each edit postpones the sync, so a burst of edits is submitted once
+            nNameDeadline   = system::get_time_millis() + NAME_SYNC_DELAY;
+            if (ch->bNameChanged)
+                return;
+
+            if (vDirtyNames.add(ch))
+                ch->bNameChanged    = true;
+        }
+
+        bool ab_tester_ui::submit_channel_names(core::KVTStorage *kvt)
         {
-            char kvt_name[0x80];
             core::kvt_param_t kparam;
 
-            // Submit new value to KVT
-            snprintf(kvt_name, sizeof(kvt_name), "/channel/%d/name", id);
-            kparam.type     = core::KVT_STRING;
-            kparam.str      = name;
-            lsp_trace("%s = %s", kvt_name, kparam.str);
-            kvt->put(kvt_name, &kparam, core::KVT_TO_DSP);
-            wrapper()->kvt_notify_write(kvt, kvt_name, &kparam);
+            // Submit all names as a single value to KVT
+            kparam.type         = core::KVT_BLOB;
+            kparam.blob.ctype   = channel_names::CONTENT_TYPE;
+            kparam.blob.data    = sNames.encode(&kparam.blob.size);
+            if (kparam.blob.data == NULL)
+                return false;
+            lsp_trace("%s = %d bytes", KVT_CHANNEL_NAMES, int(kparam.blob.size));
+            if (kvt->put(KVT_CHANNEL_NAMES, &kparam, core::KVT_TO_DSP) != STATUS_OK)
+                return false;
+            wrapper()->kvt_notify_write(kvt, KVT_CHANNEL_NAMES, &kparam);
+            return true;
         }
 
-        void ab_tester_ui::idle()
+        void ab_tester_ui::remove_legacy_names(core::KVTStorage *kvt)
         {
-            // Scan the list of instrument names for changes
-            size_t changes = 0;
-            for (size_t i=0, n=vChannels.size(); i<n; ++i)
+            // The names are stored in the blob now, so keys of previous versions are not saved anymore
+            char key[0x20];
+            for (size_t i=0; nLegacyNames != 0; ++i, nLegacyNames >>= 1)
             {
-                channel_t *c = vChannels.uget(i);
-                if ((c->wName != NULL) && (c->bNameChanged))
-                    ++changes;
+                if (!(nLegacyNames & 1))
+                    continue;
+                snprintf(key, sizeof(key), "/channel/%d/name", int(i + 1));
+                lsp_trace("Removing migrated %s", key);
+                kvt->remove(key);
             }
+        }
 
-            // Apply instrument names to KVT
-            if (changes > 0)
+        void ab_tester_ui::idle()
+        {
+            // Nothing to do until some channel name changes and the edit settles down
+            if (vDirtyNames.is_empty())
+                return;
+            if (system::get_time_millis() < nNameDeadline)
+                return;
+
+            AB_TRACE_SCOPE("ui.idle");
+
+            // Apply all pending instrument names to KVT at once
+            core::KVTStorage *kvt = wrapper()->kvt_lock();
+            if (kvt != NULL)
             {
-                core::KVTStorage *kvt = wrapper()->kvt_lock();
-                if (kvt != NULL)
-                {
-                    sync_channel_names(kvt);
-                    wrapper()->kvt_release();
-                }
+                sync_channel_names(kvt);
+                wrapper()->kvt_release();
             }
         }
 
         void ab_tester_ui::kvt_changed(core::KVTStorage *kvt, const char *id, const core::kvt_param_t *value)
         {
-            if ((value->type == core::KVT_STRING) && (::strstr(id, "/channel/") == id))
+            if ((value->type == core::KVT_BLOB) && (::strcmp(id, KVT_CHANNEL_NAMES) == 0))
             {
+                AB_TRACE_SCOPE("ui.restore_names");
+
+                // Restore all names at once
+                const system::time_millis_t start = system::get_time_millis();
+                if (sNames.decode(value->blob.data, value->blob.size) != STATUS_OK)
+                    return;
+                bNamesBlob              = true;
+                apply_channel_names();
+                lsp_trace("Channel names restored in %d ms", int(system::get_time_millis() - start));
+            }
+            else if ((!bNamesBlob) && (value->type == core::KVT_STRING) && (::strstr(id, "/channel/") == id))
+            {
+                // Names stored by previous versions are migrated to the blob
                 id += ::strlen("/channel/");
 
                 char *endptr = NULL;
@@ -356,7 +621,8 @@ namespace lsp
                             continue;
 
                         c->wName->text()->set_raw(value->str);
-                        c->bNameChanged = false;
+                        channel_name_changed(c);
+                        nLegacyNames       |= uint32_t(1) << ((c->nIndex - 1) & 0x1f);
                     }
                 }
             }
@@ -384,6 +650,40 @@ namespace lsp
                 // Upate grid
                 update_blind_grid();
             }
+            else if ((value->type == core::KVT_UINT64) && (strcmp(id, KVT_REMOTE_STATE) == 0))
+                apply_remote_state(value->u64);
+        }
+
+        static void set_remote_value(ui::IPort *port, float value)
+        {
+            if ((port == NULL) || (port->value() == value))
+                return;
+            port->set_value(value);
+            port->notify_all(ui::PORT_USER_EDIT);
+        }
+
+        void ab_tester_ui::apply_remote_state(uint64_t state)
+        {
+            // Only values changed by MIDI or OSC are written back to the ports, so they are
+            // saved with the session, other values already match the ports
+            bRemoteApply    = true;
+
+            if (state & (uint64_t(1) << 49))
+                set_remote_value(pBlindTest, (state & (uint64_t(1) << 36)) ? 1.0f : 0.0f);
+            if (state & (uint64_t(1) << 50))
+                set_remote_value(pMono, (state & (uint64_t(1) << 37)) ? 1.0f : 0.0f);
+            if (state & (uint64_t(1) << 48))
+                set_remote_value(pSelector, (state >> 32) & 0xf);
+
+            for (size_t i=0, n=lsp_min(vChannels.size(), size_t(8)); i<n; ++i)
+            {
+                channel_t *c    = vChannels.uget(i);
+                if ((c == NULL) || (!(state & (uint64_t(1) << (40 + c->nIndex - 1)))))
+                    continue;
+                set_remote_value(c->pRating, (state >> (4 * (c->nIndex - 1))) & 0xf);
+            }
+
+            bRemoteApply    = false;
         }
 
         status_t ab_tester_ui::reset_settings()
@@ -392,18 +692,10 @@ namespace lsp
             if (kvt != NULL)
             {
                 // Reset all names for all instruments
-                for (size_t i=0, n=vChannels.size(); i<n; ++i)
-                {
-                    channel_t *c = vChannels.uget(i);
-                    if (c->wName == NULL)
-                        continue;
-
-                    c->wName->text()->set("lists.ab_tester.instance");
-                    c->wName->text()->params()->set_int("id", int(c->nIndex));
-                    c->bNameChanged  = true;
-                }
-
-                sync_channel_names(kvt);
+                sNames.clear(vChannels.size());
+                apply_channel_names();
+                if (submit_channel_names(kvt))
+                    remove_legacy_names(kvt);
                 wrapper()->kvt_release();
             }
 
@@ -413,20 +705,50 @@ namespace lsp
         void ab_tester_ui::sync_channel_names(core::KVTStorage *kvt)
         {
             LSPString value;
+            bool changed = false;
 
-            for (size_t i=0, n=vChannels.size(); i<n; ++i)
+            for (size_t i=0, n=vDirtyNames.size(); i<n; ++i)
             {
-                channel_t *c = vChannels.uget(i);
-                if ((c->wName == NULL) || (!c->bNameChanged))
+                channel_t *c = vDirtyNames.uget(i);
+                c->bNameChanged = false;
+                if (c->wName == NULL)
                     continue;
 
                 // Obtain the new instrument name
                 if (c->wName->text()->format(&value) != STATUS_OK)
                     continue;
+                if (sNames.set(c->nIndex - 1, value.get_utf8()))
+                    changed         = true;
+            }
+
+            vDirtyNames.clear();
 
-                // Submit new value to KVT
-                set_channel_name(kvt, c->nIndex, value.get_utf8());
+            // Submit all names at once, the migrated names are removed when the blob is stored
+            if (((changed) || (nLegacyNames != 0)) && (submit_channel_names(kvt)))
+                remove_legacy_names(kvt);
+        }
+
+        void ab_tester_ui::apply_channel_names()
+        {
+            for (size_t i=0, n=vChannels.size(); i<n; ++i)
+            {
+                channel_t *c = vChannels.uget(i);
+                c->bNameChanged = false;
+                if (c->wName == NULL)
+                    continue;
+
+                // Empty name stands for the default name of the channel
+                const char *name = sNames.get(c->nIndex - 1);
+                if (name[0] == '\0')
+                {
+                    c->wName->text()->set("lists.ab_tester.instance");
+                    c->wName->text()->params()->set_int("id", int(c->nIndex));
+                }
+                else
+                    c->wName->text()->set_raw(name);
             }
+
+            vDirtyNames.clear();
         }
 
         void ab_tester_ui::reset_ratings()
@@ -442,74 +764,42 @@ namespace lsp
             }
         }
 
-        ssize_t ab_tester_ui::cmp_channels(const channel_t *a, const channel_t *b)
-        {
-            if (a->nRandom == b->nRandom)
-                return 0;
-
-            return (a->nRandom < b->nRandom) ? -1 : 1;
-        }
-
-        void ab_tester_ui::shuffle_data()
+        void ab_tester_ui::restart_blind_test()
         {
+            // The permutation is generated by the plugin and received with the KVT
             reset_ratings();
 
-            // Re-shuffle channels
-            for (size_t i=0, n=vShuffled.size(); i<n; ++i)
-            {
-                channel_t *c    = vShuffled.uget(i);
-                if (c == NULL)
-                    continue;
-
-                c->nRandom      = rand();
-            }
-            vShuffled.qsort(cmp_channels);
-
             // Clear blind test selector
             if (pSelector != NULL)
             {
                 pSelector->set_value(0);
                 pSelector->notify_all(ui::PORT_USER_EDIT);
             }
-
-            // Store shuffle state
-            uint32_t shuffle_data = 0;
-            for (size_t i=0, n=vShuffled.size(); i<n; ++i)
-            {
-                channel_t *c    = vShuffled.uget(i);
-                if (c == NULL)
-                    continue;
-
-                shuffle_data   |= (((c->nIndex-1) & 0x7) | 0x8) << (4 * i);
-            }
-
-            core::KVTStorage *kvt = pWrapper->kvt_lock();
-            if (kvt != NULL)
-            {
-                lsp_finally { pWrapper->kvt_release(); };
-
-                core::kvt_param_t kparam;
-                kparam.type     = core::KVT_UINT32;
-                kparam.u32      = shuffle_data;
-
-                lsp_trace("%s = 0x%x", KVT_SHUFFLE_INDICES, int(kparam.u32));
-                kvt->put(KVT_SHUFFLE_INDICES, &kparam, core::KVT_TO_DSP);
-                wrapper()->kvt_notify_write(kvt, KVT_SHUFFLE_INDICES, &kparam);
-            }
-            else
-                update_blind_grid();
         }
 
         void ab_tester_ui::update_blind_grid()
         {
-            // Update grid
-            if (wBlindGrid == NULL)
+            AB_TRACE_SCOPE("ui.update_blind_grid");
+
+            // Update grid, the view applies the actual state when built
+            if ((!bBlindView) || (wBlindGrid == NULL))
                 return;
 
-//            wBlindGrid->remove_all();
-            for (size_t i=0, n=vChannels.size(); i<n; ++i)
+            // Find the first row that differs from the actual layout
+            const size_t n_old  = vGridOrder.size();
+            const size_t n_new  = vShuffled.size();
+            size_t first        = 0;
+            while ((first < n_old) && (first < n_new) && (vGridOrder.uget(first) == vShuffled.uget(first)))
+                ++first;
+            if ((first >= n_old) && (first >= n_new))
+                return;
+
+            // Cells of the grid are placed in the order of insertion, so the rows before
+            // the first difference stay in place and only the rest of rows is re-inserted.
+            // The grid is re-laid out once on the next frame.
+            for (size_t i=first; i<n_old; ++i)
             {
-                channel_t *c    = vChannels.uget(i);
+                channel_t *c    = vGridOrder.uget(i);
                 if (c == NULL)
                    continue;
 
@@ -518,8 +808,9 @@ namespace lsp
                 wBlindGrid->remove(c->wBlindSelector);
                 wBlindGrid->remove(c->wBlindSeparator);
             }
+            vGridOrder.truncate(first);
 
-            for (size_t i=0, n=vShuffled.size(); i<n; ++i)
+            for (size_t i=first; i<n_new; ++i)
             {
                 channel_t *c    = vShuffled.uget(i);
                 if (c == NULL)
@@ -530,33 +821,33 @@ namespace lsp
                 wBlindGrid->add(c->wBlindRating);
                 wBlindGrid->add(c->wBlindSelector);
                 wBlindGrid->add(c->wBlindSeparator, 1, 4);
+                vGridOrder.add(c);
             }
         }
 
         void ab_tester_ui::blind_test_enable()
         {
-            // Form list of ports for shuffling
-            vShuffled.clear();
+            // Count inputs that take part in the blind test, unused inputs do not participate
+            const size_t used = (pInputs != NULL) ? size_t(pInputs->value()) : vChannels.size();
+            size_t count = 0;
             for (size_t i=0, n=vChannels.size(); i<n; ++i)
             {
                 channel_t *c = vChannels.uget(i);
-                if (c == NULL)
+                if ((c == NULL) || (c->nIndex > used))
                     continue;
-                bool enabled = (c->pEnable != NULL) ? c->pEnable->value() >= 0.5f : true;
-                if (enabled)
-                {
-                    if (!vShuffled.add(c))
-                        return;
-                }
+                if ((c->pEnable == NULL) || (c->pEnable->value() >= 0.5f))
+                    ++count;
             }
-            if (vShuffled.size() < 2)
+
+            // The plugin does not enter the blind test mode, reflect it on the switch
+            if (count < 2)
             {
                 pBlindTest->set_value(0.0f);
                 pBlindTest->notify_all(ui::PORT_USER_EDIT);
                 return;
             }
 
-            shuffle_data();
+            restart_blind_test();
         }
 
         status_t ab_tester_ui::slot_select_updated(tk::Widget *sender, void *ptr, void *data)
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/ui/channel_names.h>
+
+namespace lsp
+{
+    namespace plugui
+    {
+        static const uint8_t MAGIC[4]           = { 'A', 'B', 'C', 'N' };
+
+        const char *channel_names::CONTENT_TYPE = "application/x-lsp-ab-tester-names";
+
+        channel_names::channel_names()
+        {
+            nCount          = 0;
+            for (size_t i=0; i<MAX_CHANNELS; ++i)
+                vNames[i]       = NULL;
+            vBlob           = NULL;
+            nBlobCap        = 0;
+        }
+
+        channel_names::~channel_names()
+        {
+            clear(0);
+            if (vBlob != NULL)
+            {
+                lsp::free(vBlob);
+                vBlob           = NULL;
+            }
+            nBlobCap        = 0;
+        }
+
+        char *channel_names::copy_name(const char *name, size_t len)
+        {
+            char *dst       = lsp::malloc<char>(len + 1);
+            if (dst == NULL)
+                return NULL;
+            ::memcpy(dst, name, len);
+            dst[len]        = '\0';
+            return dst;
+        }
+
+        void channel_names::clear(size_t count)
+        {
+            nCount          = (count < MAX_CHANNELS) ? count : MAX_CHANNELS;
+            for (size_t i=0; i<MAX_CHANNELS; ++i)
+            {
+                if (vNames[i] != NULL)
+                {
+                    lsp::free(vNames[i]);
+                    vNames[i]       = NULL;
+                }
+            }
+        }
+
+        bool channel_names::set(size_t index, const char *name)
+        {
+            if (index >= nCount)
+                return false;
+            if (name == NULL)
+                name            = "";
+
+            // Truncate the name without splitting the multi-byte character
+            size_t len      = ::strlen(name);
+            if (len > MAX_NAME_BYTES)
+            {
+                len             = MAX_NAME_BYTES;
+                while ((len > 0) && ((uint8_t(name[len]) & 0xc0) == 0x80))
+                    --len;
+            }
+
+            const char *old = get(index);
+            if ((::strncmp(old, name, len) == 0) && (old[len] == '\0'))
+                return false;
+
+            // The empty name is the default name, it takes no memory
+            char *dst       = NULL;
+            if (len > 0)
+            {
+                if ((dst = copy_name(name, len)) == NULL)
+                    return false;
+            }
+
+            if (vNames[index] != NULL)
+                lsp::free(vNames[index]);
+            vNames[index]   = dst;
+            return true;
+        }
+
+        const char *channel_names::get(size_t index) const
+        {
+            return ((index < nCount) && (vNames[index] != NULL)) ? vNames[index] : "";
+        }
+
+        const void *channel_names::encode(size_t *size)
+        {
+            // Estimate the size of the blob and grow the buffer if needed
+            size_t bytes    = HEADER_BYTES;
+            for (size_t i=0; i<nCount; ++i)
+                bytes          += LENGTH_BYTES + ::strlen(get(i));
+            if (bytes > nBlobCap)
+            {
+                uint8_t *blob   = lsp::realloc<uint8_t>(vBlob, bytes);
+                if (blob == NULL)
+                    return NULL;
+                vBlob           = blob;
+                nBlobCap        = bytes;
+            }
+
+            uint8_t *p      = vBlob;
+            ::memcpy(p, MAGIC, sizeof(MAGIC));
+            p[4]            = VERSION;
+            p[5]            = uint8_t(nCount);
+            p[6]            = 0;
+            p[7]            = 0;
+            p              += HEADER_BYTES;
+
+            for (size_t i=0; i<nCount; ++i)
+            {
+                const char *name    = get(i);
+                const size_t len    = ::strlen(name);
+                p[0]                = uint8_t(len & 0xff);
+                p[1]                = uint8_t(len >> 8);
+                ::memcpy(&p[LENGTH_BYTES], name, len);
+                p                  += LENGTH_BYTES + len;
+            }
+
+            *size           = bytes;
+            return vBlob;
+        }
+
+        status_t channel_names::decode(const void *data, size_t size)
+        {
+            const uint8_t *p    = static_cast<const uint8_t *>(data);
+            if ((p == NULL) || (size < HEADER_BYTES))
+                return STATUS_CORRUPTED;
+            if (::memcmp(p, MAGIC, sizeof(MAGIC)) != 0)
+                return STATUS_BAD_FORMAT;
+            if (p[4] != VERSION)
+                return STATUS_UNSUPPORTED_FORMAT;
+
+            const size_t count  = p[5];
+            if (count > MAX_CHANNELS)
+                return STATUS_CORRUPTED;
+
+            // Validate all records before modifying any name
+            const uint8_t *end  = &p[size];
+            const uint8_t *q    = &p[HEADER_BYTES];
+            for (size_t i=0; i<count; ++i)
+            {
+                if (size_t(end - q) < LENGTH_BYTES)
+                    return STATUS_CORRUPTED;
+                const size_t len    = size_t(q[0]) | (size_t(q[1]) << 8);
+                q                  += LENGTH_BYTES;
+                if (size_t(end - q) < len)
+                    return STATUS_CORRUPTED;
+                q                  += len;
+            }
+            if (q != end)
+                return STATUS_CORRUPTED;
+
+            // Records of channels missing in the blob stay default
+            status_t res        = STATUS_OK;
+            q                   = &p[HEADER_BYTES];
+            for (size_t i=0; i<nCount; ++i)
+            {
+                char *name          = NULL;
+                if (i < count)
+                {
+                    const size_t len    = size_t(q[0]) | (size_t(q[1]) << 8);
+                    q                  += LENGTH_BYTES;
+                    if ((len > 0) && ((name = copy_name(reinterpret_cast<const char *>(q), len)) == NULL))
+                        res                 = STATUS_NO_MEM;
+                    q                  += len;
+                }
+
+                if (vNames[i] != NULL)
+                    lsp::free(vNames[i]);
+                vNames[i]           = name;
+            }
+
+            return res;
+        }
+
+    } /* namespace plugui */
+} /* namespace lsp */
@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/debug.h>
+
+#include <private/ui/rating_bar.h>
+
+namespace lsp
+{
+    namespace tk
+    {
+        namespace style
+        {
+            LSP_TK_STYLE_IMPL_BEGIN(RatingBar, Widget)
+                // Bind
+                sValue.bind("value", this);
+                sLevels.bind("levels", this);
+                sActive.bind("active", this);
+                sSpacing.bind("spacing", this);
+                sCellWidth.bind("cell.width", this);
+                sBorderRadius.bind("border.radius", this);
+                sColor.bind("color", this);
+                sBorderColor.bind("border.color", this);
+                sDownColor.bind("down.color", this);
+                sDownBorderColor.bind("border.down.color", this);
+                sInactiveColor.bind("inactive.color", this);
+                sInactiveBorderColor.bind("inactive.border.color", this);
+                // Configure
+                sValue.set(0);
+                sLevels.set(10);
+                sActive.set(true);
+                sSpacing.set(2);
+                sCellWidth.set(12);
+                sBorderRadius.set(2);
+                sColor.set("#cccccc");
+                sBorderColor.set("#000000");
+                sDownColor.set("#00c0ff");
+                sDownBorderColor.set("#000000");
+                sInactiveColor.set("#888888");
+                sInactiveBorderColor.set("#444444");
+            LSP_TK_STYLE_IMPL_END
+            LSP_TK_BUILTIN_STYLE(RatingBar, "RatingBar", "root");
+        } /* namespace style */
+
+        const w_class_t RatingBar::metadata     = { "RatingBar", &Widget::metadata };
+
+        RatingBar::RatingBar(Display *dpy):
+            Widget(dpy),
+            sValue(&sProperties),
+            sLevels(&sProperties),
+            sActive(&sProperties),
+            sSpacing(&sProperties),
+            sCellWidth(&sProperties),
+            sBorderRadius(&sProperties),
+            sColor(&sProperties),
+            sBorderColor(&sProperties),
+            sDownColor(&sProperties),
+            sDownBorderColor(&sProperties),
+            sInactiveColor(&sProperties),
+            sInactiveBorderColor(&sProperties)
+        {
+            nBMask              = 0;
+
+            pClass              = &metadata;
+        }
+
+        RatingBar::~RatingBar()
+        {
+            nFlags     |= FINALIZED;
+        }
+
+        status_t RatingBar::init()
+        {
+            status_t res = Widget::init();
+            if (res != STATUS_OK)
+                return res;
+
+            sValue.bind("value", &sStyle);
+            sLevels.bind("levels", &sStyle);
+            sActive.bind("active", &sStyle);
+            sSpacing.bind("spacing", &sStyle);
+            sCellWidth.bind("cell.width", &sStyle);
+            sBorderRadius.bind("border.radius", &sStyle);
+            sColor.bind("color", &sStyle);
+            sBorderColor.bind("border.color", &sStyle);
+            sDownColor.bind("down.color", &sStyle);
+            sDownBorderColor.bind("border.down.color", &sStyle);
+            sInactiveColor.bind("inactive.color", &sStyle);
+            sInactiveBorderColor.bind("inactive.border.color", &sStyle);
+
+            handler_id_t id = sSlots.add(SLOT_CHANGE, slot_on_change, self());
+            if (id < 0)
+                return -id;
+
+            return STATUS_OK;
+        }
+
+        void RatingBar::property_changed(Property *prop)
+        {
+            Widget::property_changed(prop);
+
+            if ((sLevels.is(prop)) || (sSpacing.is(prop)) || (sCellWidth.is(prop)))
+                query_resize();
+
+            if ((sValue.is(prop)) || (sActive.is(prop)) || (sBorderRadius.is(prop)))
+                query_draw();
+            if ((sColor.is(prop)) || (sBorderColor.is(prop)) ||
+                (sDownColor.is(prop)) || (sDownBorderColor.is(prop)))
+                query_draw();
+            if ((sInactiveColor.is(prop)) || (sInactiveBorderColor.is(prop)))
+                query_draw();
+        }
+
+        void RatingBar::size_request(ws::size_limit_t *r)
+        {
+            const float scaling     = lsp_max(0.0f, sScaling.get());
+            const ssize_t levels    = lsp_max(sLevels.get(), 1);
+            const ssize_t spacing   = (sSpacing.get() > 0) ? lsp_max(1.0f, sSpacing.get() * scaling) : 0;
+            const ssize_t cell      = lsp_max(1.0f, sCellWidth.get() * scaling);
+
+            r->nMinWidth            = cell * levels + spacing * (levels - 1);
+            r->nMinHeight           = cell;
+            r->nMaxWidth            = -1;
+            r->nMaxHeight           = -1;
+            r->nPreWidth            = -1;
+            r->nPreHeight           = -1;
+        }
+
+        void RatingBar::draw(ws::ISurface *s, bool force)
+        {
+            const float scaling     = lsp_max(0.0f, sScaling.get());
+            const float bright      = sBrightness.get();
+            const ssize_t levels    = lsp_max(sLevels.get(), 1);
+            const ssize_t value     = sValue.get();
+            const bool active       = sActive.get();
+            const ssize_t spacing   = (sSpacing.get() > 0) ? lsp_max(1.0f, sSpacing.get() * scaling) : 0;
+            const float radius      = lsp_max(0.0f, sBorderRadius.get() * scaling);
+            const ssize_t width     = lsp_max(ssize_t(0), sSize.nWidth - spacing * (levels - 1));
+
+            // Draw background
+            lsp::Color color;
+            get_actual_bg_color(color);
+            s->clear(color);
+
+            // Draw all levels at once
+            lsp::Color border;
+            bool aa                 = s->set_antialiasing(true);
+            for (ssize_t i=0; i<levels; ++i)
+            {
+                const ssize_t left      = (width * i) / levels;
+                const ssize_t right     = (width * (i + 1)) / levels;
+                const ssize_t x         = left + spacing * i;
+                const ssize_t w         = right - left;
+                if (w <= 0)
+                    continue;
+
+                if (!active)
+                {
+                    color.copy(sInactiveColor.color());
+                    border.copy(sInactiveBorderColor.color());
+                }
+                else if (i < value)
+                {
+                    color.copy(sDownColor.color());
+                    border.copy(sDownBorderColor.color());
+                }
+                else
+                {
+                    color.copy(sColor.color());
+                    border.copy(sBorderColor.color());
+                }
+                color.scale_lch_luminance(bright);
+                border.scale_lch_luminance(bright);
+
+                s->fill_rect(color, SURFMASK_ALL_CORNER, radius, x, 0, w, sSize.nHeight);
+                s->wire_rect(border, SURFMASK_ALL_CORNER, radius, x + 0.5f, 0.5f, w - 1, sSize.nHeight - 1, 1.0f);
+            }
+            s->set_antialiasing(aa);
+        }
+
+        ssize_t RatingBar::find_level(ssize_t x)
+        {
+            const float scaling     = lsp_max(0.0f, sScaling.get());
+            const ssize_t levels    = lsp_max(sLevels.get(), 1);
+            const ssize_t spacing   = (sSpacing.get() > 0) ? lsp_max(1.0f, sSpacing.get() * scaling) : 0;
+            const ssize_t width     = sSize.nWidth - spacing * (levels - 1);
+            if (width <= 0)
+                return -1;
+
+            // Clicks on spacing between levels belong to the next level
+            x                      -= sSize.nLeft;
+            if ((x < 0) || (x >= sSize.nWidth))
+                return -1;
+
+            const ssize_t level     = ((x + spacing) * levels) / (width + spacing * levels);
+            return lsp_limit(level, ssize_t(0), levels - 1);
+        }
+
+        status_t RatingBar::on_mouse_down(const ws::event_t *e)
+        {
+            nBMask         |= size_t(1) << e->nCode;
+            if (nBMask != ws::MCF_LEFT)
+                return STATUS_OK;
+
+            return on_mouse_move(e);
+        }
+
+        status_t RatingBar::on_mouse_up(const ws::event_t *e)
+        {
+            nBMask         &= ~(size_t(1) << e->nCode);
+            return STATUS_OK;
+        }
+
+        status_t RatingBar::on_mouse_move(const ws::event_t *e)
+        {
+            if (nBMask != ws::MCF_LEFT)
+                return STATUS_OK;
+
+            const ssize_t level = find_level(e->nLeft);
+            if ((level < 0) || (sValue.get() == level + 1))
+                return STATUS_OK;
+
+            sValue.set(level + 1);
+            sSlots.execute(SLOT_CHANGE, this);
+
+            return STATUS_OK;
+        }
+
+        status_t RatingBar::slot_on_change(Widget *sender, void *ptr, void *data)
+        {
+            RatingBar *_this = widget_ptrcast<RatingBar>(ptr);
+            return (_this != NULL) ? _this->on_change() : STATUS_BAD_ARGUMENTS;
+        }
+
+        status_t RatingBar::on_change()
+        {
+            return STATUS_OK;
+        }
+
+    } /* namespace tk */
+} /* namespace lsp */
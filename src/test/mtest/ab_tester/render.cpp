@@ -0,0 +1,395 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <lsp-plug.in/ipc/Thread.h>
+#include <lsp-plug.in/runtime/system.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/test-fw/mtest.h>
+
+#include <private/meta/ab_tester.h>
+#include <private/test/offline_host.h>
+
+/*
+ * Offline batch renderer.
+ *
+ * Renders each candidate through the same plugin configuration into a separate
+ * audio file. Each candidate is rendered by an own plugin instance, candidates
+ * are distributed between worker threads.
+ *
+ * Usage:
+ *   mtest ab_tester.render [options] file1 file2 ...
+ *
+ * Options:
+ *   -v <variant>       plugin variant, for example ab_tester_x4_stereo
+ *   -o <directory>     output directory, temporary directory by default
+ *   -r <rate>          sample rate, sample rate of the first file by default
+ *   -b <block>         block size in samples
+ *   -j <jobs>          number of parallel jobs, one job per candidate by default
+ *   -l                 level-match candidates by RMS to the quietest one
+ *   -p <port>=<value>  set value of the plugin port
+ */
+
+namespace
+{
+    using namespace lsp;
+
+    static const size_t DEFAULT_BLOCK_SIZE  = 0x2000;
+    static const size_t MAX_PARAMS          = 32;
+
+    static const meta::plugin_t *variants[] =
+    {
+        &meta::ab_tester_x2_mono,
+        &meta::ab_tester_x4_mono,
+        &meta::ab_tester_x8_mono,
+        &meta::ab_tester_x2_stereo,
+        &meta::ab_tester_x4_stereo,
+        &meta::ab_tester_x8_stereo,
+        NULL
+    };
+
+    typedef struct param_t
+    {
+        char                    sId[32];
+        float                   fValue;
+    } param_t;
+
+    typedef struct config_t
+    {
+        const meta::plugin_t   *pMeta;
+        const char             *sOutDir;
+        size_t                  nSampleRate;
+        size_t                  nBlockSize;
+        size_t                  nJobs;
+        bool                    bLevelMatch;
+        size_t                  nParams;
+        param_t                 vParams[MAX_PARAMS];
+        size_t                  nFiles;
+        dspu::Sample           *vFiles;
+        float                  *vGains;
+        size_t                  nLength;
+        uatomic_t               nNextJob;
+        uatomic_t               nErrors;
+    } config_t;
+
+    class Worker: public ipc::Thread
+    {
+        protected:
+            config_t       *pConfig;
+
+        protected:
+            status_t render(size_t candidate)
+            {
+                config_t *cfg   = pConfig;
+                test::offline_host host;
+
+                status_t res    = host.init(cfg->pMeta, cfg->nSampleRate);
+                if (res != STATUS_OK)
+                    return res;
+
+                const size_t inputs     = host.inputs();
+                const size_t outputs    = host.outputs();
+                const size_t in_per_ch  = outputs;  // Each candidate has as many inputs as outputs
+                const size_t block      = cfg->nBlockSize;
+
+                // Apply the configuration
+                for (size_t i=0; i<cfg->nParams; ++i)
+                    if (!host.set(cfg->vParams[i].sId, cfg->vParams[i].fValue))
+                        fprintf(stderr, "Unknown port id: %s\n", cfg->vParams[i].sId);
+                for (size_t i=0; i<cfg->nFiles; ++i)
+                {
+                    char id[32];
+                    snprintf(id, sizeof(id), "g_%d", int(i + 1));
+                    host.set(id, cfg->vGains[i]);
+                }
+                host.set("sel", candidate + 1);
+
+                // Allocate the output sample and the buffers for the tails of short files
+                dspu::Sample out;
+                if (!out.init(outputs, cfg->nLength, cfg->nLength))
+                    return STATUS_NO_MEM;
+                out.set_sample_rate(cfg->nSampleRate);
+
+                float *tail     = static_cast<float *>(malloc(inputs * block * sizeof(float)));
+                if (tail == NULL)
+                    return STATUS_NO_MEM;
+                lsp_finally { free(tail); };
+
+                // Render the whole file with large blocks
+                for (size_t offset=0; offset < cfg->nLength; )
+                {
+                    const size_t to_do  = lsp_min(cfg->nLength - offset, block);
+
+                    for (size_t i=0; i<inputs; ++i)
+                    {
+                        const size_t file_id    = i / in_per_ch;
+                        const dspu::Sample *s   = (file_id < cfg->nFiles) ? &cfg->vFiles[file_id] : NULL;
+                        const float *src        = (s != NULL) ? s->channel((i % in_per_ch) % s->channels()) : NULL;
+                        const size_t avail      = ((s != NULL) && (s->length() > offset)) ? s->length() - offset : 0;
+
+                        // Feed the file data directly, pad the tail of the file with silence
+                        if (avail >= to_do)
+                            host.bind_input(i, &src[offset]);
+                        else
+                        {
+                            float *buf              = &tail[i * block];
+                            if (avail > 0)
+                                dsp::copy(buf, &src[offset], avail);
+                            dsp::fill_zero(&buf[avail], to_do - avail);
+                            host.bind_input(i, buf);
+                        }
+                    }
+                    for (size_t i=0; i<outputs; ++i)
+                        host.bind_output(i, out.channel(i) + offset);
+
+                    host.process(to_do);
+                    offset         += to_do;
+                }
+
+                // Save the result
+                char path[PATH_MAX];
+                snprintf(path, sizeof(path), "%s/%s-%d.wav", cfg->sOutDir, cfg->pMeta->uid, int(candidate + 1));
+                ssize_t written = out.save(path);
+                if (written < 0)
+                {
+                    fprintf(stderr, "Could not save file %s: error code %d\n", path, int(-written));
+                    return status_t(-written);
+                }
+
+                printf("  rendered candidate %d into %s\n", int(candidate + 1), path);
+                return STATUS_OK;
+            }
+
+        public:
+            explicit Worker(config_t *cfg)
+            {
+                pConfig     = cfg;
+            }
+
+            virtual status_t run() override
+            {
+                while (true)
+                {
+                    const size_t job = atomic_add(&pConfig->nNextJob, 1);
+                    if (job >= pConfig->nFiles)
+                        break;
+                    if (render(job) != STATUS_OK)
+                        atomic_add(&pConfig->nErrors, 1);
+                }
+
+                return STATUS_OK;
+            }
+    };
+}
+
+MTEST_BEGIN("ab_tester", render)
+
+    bool parse_args(config_t *cfg, int *first, int argc, const char **argv)
+    {
+        *first          = argc;
+        for (int i=0; i<argc; ++i)
+        {
+            const char *arg = argv[i];
+            const char *val = (i + 1 < argc) ? argv[i+1] : NULL;
+
+            if (!strcmp(arg, "-l"))
+            {
+                cfg->bLevelMatch    = true;
+                continue;
+            }
+            else if (arg[0] != '-')
+            {
+                *first          = i;
+                return true;
+            }
+            else if (val == NULL)
+            {
+                fprintf(stderr, "Missing value for the argument %s\n", arg);
+                return false;
+            }
+
+            ++i;
+            if (!strcmp(arg, "-v"))
+            {
+                cfg->pMeta          = NULL;
+                for (const meta::plugin_t * const *v = variants; *v != NULL; ++v)
+                    if (!strcmp((*v)->uid, val))
+                        cfg->pMeta          = *v;
+                if (cfg->pMeta == NULL)
+                {
+                    fprintf(stderr, "Unknown plugin variant: %s\n", val);
+                    return false;
+                }
+            }
+            else if (!strcmp(arg, "-o"))
+                cfg->sOutDir        = val;
+            else if (!strcmp(arg, "-r"))
+                cfg->nSampleRate    = atoi(val);
+            else if (!strcmp(arg, "-b"))
+                cfg->nBlockSize     = lsp_max(atoi(val), 1);
+            else if (!strcmp(arg, "-j"))
+                cfg->nJobs          = lsp_max(atoi(val), 1);
+            else if (!strcmp(arg, "-p"))
+            {
+                const char *eq      = strchr(val, '=');
+                if ((eq == NULL) || (cfg->nParams >= MAX_PARAMS) || (size_t(eq - val) >= sizeof(param_t::sId)))
+                {
+                    fprintf(stderr, "Invalid port assignment: %s\n", val);
+                    return false;
+                }
+                param_t *p          = &cfg->vParams[cfg->nParams++];
+                memcpy(p->sId, val, eq - val);
+                p->sId[eq - val]    = '\0';
+                p->fValue           = atof(eq + 1);
+            }
+            else
+            {
+                fprintf(stderr, "Unknown argument: %s\n", arg);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    float file_rms(const dspu::Sample *s)
+    {
+        float sum = 0.0f;
+        for (size_t i=0; i<s->channels(); ++i)
+        {
+            const float *c = s->channel(i);
+            for (size_t j=0; j<s->length(); ++j)
+                sum    += c[j] * c[j];
+        }
+
+        const size_t count = s->channels() * s->length();
+        return (count > 0) ? sqrtf(sum / count) : 0.0f;
+    }
+
+    MTEST_MAIN
+    {
+        dsp::init();
+
+        config_t cfg;
+        cfg.pMeta           = &meta::ab_tester_x2_stereo;
+        cfg.sOutDir         = tempdir();
+        cfg.nSampleRate     = 0;
+        cfg.nBlockSize      = DEFAULT_BLOCK_SIZE;
+        cfg.nJobs           = 0;
+        cfg.bLevelMatch     = false;
+        cfg.nParams         = 0;
+        cfg.nFiles          = 0;
+        cfg.vFiles          = NULL;
+        cfg.vGains          = NULL;
+        cfg.nLength         = 0;
+        atomic_store(&cfg.nNextJob, 0);
+        atomic_store(&cfg.nErrors, 0);
+
+        // Parse options, the rest of arguments are input files
+        int first           = 0;
+        MTEST_ASSERT(parse_args(&cfg, &first, argc, argv));
+        const char **files  = &argv[first];
+        const int nfiles    = argc - first;
+        MTEST_ASSERT_MSG(nfiles > 0, "No input files specified");
+
+        size_t max_files    = 0;
+        for (const meta::port_t *p = cfg.pMeta->ports; p->id != NULL; ++p)
+            if (!strncmp(p->id, "ifn", 3))
+                ++max_files;
+        cfg.nFiles          = lsp_min(size_t(nfiles), max_files);
+        if (size_t(nfiles) > max_files)
+            printf("Variant %s has only %d inputs, extra files are ignored\n", cfg.pMeta->uid, int(max_files));
+
+        // Load all input files and resample them to the same sample rate
+        dspu::Sample *samples   = new dspu::Sample[cfg.nFiles];
+        float *gains            = new float[cfg.nFiles];
+        MTEST_ASSERT((samples != NULL) && (gains != NULL));
+        lsp_finally {
+            delete [] samples;
+            delete [] gains;
+        };
+        cfg.vFiles          = samples;
+        cfg.vGains          = gains;
+
+        for (size_t i=0; i<cfg.nFiles; ++i)
+        {
+            printf("Loading file %s\n", files[i]);
+            MTEST_ASSERT(samples[i].load(files[i]) == STATUS_OK);
+            if (cfg.nSampleRate <= 0)
+                cfg.nSampleRate     = samples[i].sample_rate();
+            if (samples[i].sample_rate() != cfg.nSampleRate)
+                MTEST_ASSERT(samples[i].resample(cfg.nSampleRate) == STATUS_OK);
+            cfg.nLength         = lsp_max(cfg.nLength, samples[i].length());
+        }
+
+        // Compute the gains for level matching
+        float min_rms       = -1.0f;
+        for (size_t i=0; i<cfg.nFiles; ++i)
+        {
+            gains[i]            = file_rms(&samples[i]);
+            if ((gains[i] > 0.0f) && ((min_rms < 0.0f) || (gains[i] < min_rms)))
+                min_rms             = gains[i];
+        }
+        for (size_t i=0; i<cfg.nFiles; ++i)
+        {
+            const float rms     = gains[i];
+            gains[i]            = ((cfg.bLevelMatch) && (rms > 0.0f)) ? min_rms / rms : 1.0f;
+            if (cfg.bLevelMatch)
+                printf("  candidate %d: RMS=%.2f dB, gain=%.2f dB\n",
+                    int(i + 1), 20.0f * log10f(lsp_max(rms, 1e-10f)), 20.0f * log10f(gains[i]));
+        }
+
+        // Launch workers
+        const size_t jobs   = (cfg.nJobs > 0) ? lsp_min(cfg.nJobs, cfg.nFiles) : cfg.nFiles;
+        printf("Rendering %d candidates of %d samples at %d Hz with %d jobs, block size %d\n",
+            int(cfg.nFiles), int(cfg.nLength), int(cfg.nSampleRate), int(jobs), int(cfg.nBlockSize));
+
+        Worker **workers    = new Worker *[jobs];
+        MTEST_ASSERT(workers != NULL);
+        lsp_finally { delete [] workers; };
+
+        system::time_millis_t start = system::get_time_millis();
+        for (size_t i=0; i<jobs; ++i)
+        {
+            workers[i]          = new Worker(&cfg);
+            MTEST_ASSERT(workers[i] != NULL);
+            MTEST_ASSERT(workers[i]->start() == STATUS_OK);
+        }
+        for (size_t i=0; i<jobs; ++i)
+        {
+            workers[i]->join();
+            delete workers[i];
+        }
+        system::time_millis_t time = system::get_time_millis() - start;
+
+        // Report performance
+        const double audio  = double(cfg.nLength * cfg.nFiles) / double(cfg.nSampleRate);
+        printf("Rendered %.2f seconds of audio in %.3f seconds, %.1fx real time\n",
+            audio, time * 0.001, (time > 0) ? audio * 1000.0 / time : 0.0);
+
+        MTEST_ASSERT(atomic_load(&cfg.nErrors) == 0);
+    }
+
+MTEST_END
@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/test-fw/mtest.h>
+
+#include <private/meta/ab_tester.h>
+#include <private/test/offline_host.h>
+
+#ifdef PLATFORM_POSIX
+    #include <sys/resource.h>
+    #include <time.h>
+#endif /* PLATFORM_POSIX */
+
+/*
+ * Host simulation stress harness.
+ *
+ * Drives the plugin with randomized block sizes, randomized parameter changes
+ * between process() calls, connecting and disconnecting returns and sample rate
+ * changes. Background tasks are executed between process() calls like a host's
+ * executor does. Reports the distribution of the per-call latency and flags any
+ * memory allocation and any blocking system call made inside process().
+ *
+ * Usage:
+ *   mtest ab_tester.stress [calls]
+ */
+
+#define MAX_BLOCK       8192
+#define MAX_RETURNS     16
+#define DEFAULT_CALLS   100000
+
+namespace
+{
+    using namespace lsp;
+
+    static const meta::plugin_t *variants[] =
+    {
+        &meta::ab_tester_x2_mono,
+        &meta::ab_tester_x4_mono,
+        &meta::ab_tester_x8_mono,
+        &meta::ab_tester_x2_stereo,
+        &meta::ab_tester_x4_stereo,
+        &meta::ab_tester_x8_stereo,
+        NULL
+    };
+
+    static const long sample_rates[] = { 44100, 48000, 88200, 96000, 192000 };
+
+    // Allocation trap: counts memory management calls while the flag is set
+    static volatile bool    bTrap       = false;
+    static volatile size_t  nAllocs     = 0;
+    static volatile size_t  nFrees      = 0;
+
+    static inline uint64_t time_nanos()
+    {
+    #ifdef PLATFORM_POSIX
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+    #else
+        return 0;
+    #endif /* PLATFORM_POSIX */
+    }
+
+    static inline size_t context_switches()
+    {
+    #if defined(PLATFORM_LINUX)
+        // Voluntary context switches of the thread indicate blocking system calls
+        struct rusage ru;
+        getrusage(RUSAGE_THREAD, &ru);
+        return ru.ru_nvcsw;
+    #else
+        return 0;
+    #endif /* PLATFORM_LINUX */
+    }
+
+    static int cmp_u64(const void *a, const void *b)
+    {
+        const uint64_t va = *static_cast<const uint64_t *>(a);
+        const uint64_t vb = *static_cast<const uint64_t *>(b);
+        return (va < vb) ? -1 : (va > vb) ? 1 : 0;
+    }
+}
+
+#if defined(__GLIBC__)
+/*
+ * Interpose memory management functions of the C library. Operators new and
+ * delete use them as well, so any allocation is counted.
+ */
+extern "C"
+{
+    extern void *__libc_malloc(size_t size);
+    extern void *__libc_calloc(size_t nmemb, size_t size);
+    extern void *__libc_realloc(void *ptr, size_t size);
+    extern void __libc_free(void *ptr);
+
+    void *malloc(size_t size)
+    {
+        if (bTrap)
+            ++nAllocs;
+        return __libc_malloc(size);
+    }
+
+    void *calloc(size_t nmemb, size_t size)
+    {
+        if (bTrap)
+            ++nAllocs;
+        return __libc_calloc(nmemb, size);
+    }
+
+    void *realloc(void *ptr, size_t size)
+    {
+        if (bTrap)
+            ++nAllocs;
+        return __libc_realloc(ptr, size);
+    }
+
+    void free(void *ptr)
+    {
+        if ((bTrap) && (ptr != NULL))
+            ++nFrees;
+        __libc_free(ptr);
+    }
+}
+#endif /* __GLIBC__ */
+
+MTEST_BEGIN("ab_tester", stress)
+
+    void randomize(test::offline_host *host, core::AudioBuffer *ret, size_t returns, size_t candidates)
+    {
+        char id[32];
+
+        switch (rand() % 8)
+        {
+            case 0:
+                host->set("sel", rand() % (candidates + 1));
+                break;
+            case 1:
+                host->set("bte", rand() & 1);
+                break;
+            case 2:
+                host->set("mono", rand() & 1);
+                break;
+            case 3:
+                snprintf(id, sizeof(id), "g_%d", int(rand() % candidates) + 1);
+                host->set(id, float(rand()) / RAND_MAX);
+                break;
+            case 4:
+                snprintf(id, sizeof(id), "rate_%d", int(rand() % candidates) + 1);
+                host->set(id, (rand() % meta::ab_tester::RATE_MAX) + 1);
+                break;
+            case 5:
+                host->set("lmode", rand() % 3);
+                host->set("llen", 1.0f + (rand() % 60));
+                break;
+            case 6:
+                host->set("jon", rand() & 1);
+                break;
+            default:
+                // Connect or disconnect return
+                if (returns > 0)
+                {
+                    core::AudioBuffer *buf = &ret[rand() % returns];
+                    buf->set_active(!buf->active());
+                }
+                break;
+        }
+    }
+
+    void stress(const meta::plugin_t *meta, size_t calls, float *buf, core::AudioBuffer *ret, uint64_t *latency)
+    {
+        test::offline_host host(true);
+        long sample_rate        = sample_rates[rand() % (sizeof(sample_rates)/sizeof(long))];
+        MTEST_ASSERT(host.init(meta, sample_rate) == STATUS_OK);
+
+        const size_t inputs     = host.inputs();
+        const size_t outputs    = host.outputs();
+        const size_t returns    = lsp_min(host.returns(), size_t(MAX_RETURNS));
+        const size_t candidates = inputs / outputs;
+
+        for (size_t i=0; i<inputs; ++i)
+            host.bind_input(i, &buf[i * MAX_BLOCK]);
+        for (size_t i=0; i<outputs; ++i)
+            host.bind_output(i, &buf[(inputs + i) * MAX_BLOCK]);
+        for (size_t i=0; i<returns; ++i)
+        {
+            ret[i].set_active(false);
+            host.bind_return(i, &ret[i]);
+        }
+
+        size_t allocs           = 0;
+        size_t frees            = 0;
+        size_t switches         = 0;
+        size_t faulty           = 0;
+        uint64_t total          = 0;
+        double worst_load       = 0.0;
+
+        for (size_t i=0; i<calls; ++i)
+        {
+            // Change the sample rate from time to time like the host does
+            if ((rand() % 5000) == 0)
+            {
+                sample_rate         = sample_rates[rand() % (sizeof(sample_rates)/sizeof(long))];
+                host.set_sample_rate(sample_rate);
+            }
+
+            // Change parameters between calls
+            if ((rand() % 4) == 0)
+                randomize(&host, ret, returns, candidates);
+            host.update_settings();
+
+            // Process the block with the random size
+            const size_t block  = (rand() % MAX_BLOCK) + 1;
+
+            nAllocs             = 0;
+            nFrees              = 0;
+            size_t ctx          = context_switches();
+            bTrap               = true;
+            uint64_t start      = time_nanos();
+            host.process(block);
+            uint64_t time       = time_nanos() - start;
+            bTrap               = false;
+            ctx                 = context_switches() - ctx;
+
+            latency[i]          = time;
+            total              += time;
+            worst_load          = lsp_max(worst_load, (double(time) * sample_rate) / (double(block) * 1e+9));
+
+            if ((nAllocs > 0) || (nFrees > 0) || (ctx > 0))
+            {
+                if (faulty < 10)
+                    printf("  call %d (block=%d): %d allocations, %d frees, %d voluntary context switches\n",
+                        int(i), int(block), int(nAllocs), int(nFrees), int(ctx));
+                ++faulty;
+                allocs             += nAllocs;
+                frees              += nFrees;
+                switches           += ctx;
+            }
+
+            // Let the background tasks do their job
+            host.run_tasks();
+        }
+
+        // Report latency distribution
+        qsort(latency, calls, sizeof(uint64_t), cmp_u64);
+        printf("%s: %d calls, mean=%.1f us, p50=%.1f us, p99=%.1f us, p99.9=%.1f us, max=%.1f us, worst load=%.2f%%\n",
+            meta->uid, int(calls),
+            (total * 1e-3) / calls,
+            latency[calls / 2] * 1e-3,
+            latency[(calls * 990) / 1000] * 1e-3,
+            latency[(calls * 999) / 1000] * 1e-3,
+            latency[calls - 1] * 1e-3,
+            worst_load * 100.0);
+        printf("%s: %d calls with %d allocations, %d frees, %d voluntary context switches\n",
+            meta->uid, int(faulty), int(allocs), int(frees), int(switches));
+        printf("%s: memory footprint %d bytes\n",
+            meta->uid, int(host.plugin()->footprint()));
+
+        MTEST_ASSERT_MSG((allocs == 0) && (frees == 0), "Memory management detected on the processing path");
+    }
+
+    MTEST_MAIN
+    {
+        dsp::init();
+        srand(0x5eed);
+
+        size_t calls            = (argc > 0) ? atoi(argv[0]) : DEFAULT_CALLS;
+        if (calls <= 0)
+            calls                   = DEFAULT_CALLS;
+
+        // Allocate buffers for up to 16 inputs and 2 outputs
+        const size_t channels   = 16 + 2;
+        uint8_t *data           = NULL;
+        float *buf              = alloc_aligned<float>(data, channels * MAX_BLOCK, 64);
+        MTEST_ASSERT(buf != NULL);
+        lsp_finally { free_aligned(data); };
+        randomize_sign(buf, channels * MAX_BLOCK);
+
+        uint64_t *latency       = static_cast<uint64_t *>(malloc(calls * sizeof(uint64_t)));
+        MTEST_ASSERT(latency != NULL);
+        lsp_finally { free(latency); };
+
+        core::AudioBuffer ret[MAX_RETURNS];
+        for (size_t i=0; i<MAX_RETURNS; ++i)
+        {
+            ret[i].set_size(MAX_BLOCK);
+            MTEST_ASSERT(ret[i].buffer() != NULL);
+            randomize_sign(ret[i].buffer(), MAX_BLOCK);
+        }
+
+        for (const meta::plugin_t * const *v = variants; *v != NULL; ++v)
+            stress(*v, calls, buf, ret, latency);
+    }
+
+MTEST_END
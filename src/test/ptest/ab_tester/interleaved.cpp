@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/test-fw/ptest.h>
+
+#include <private/meta/ab_tester.h>
+#include <private/test/offline_host.h>
+
+#define MIN_RANK    8
+#define MAX_RANK    12
+
+namespace
+{
+    using namespace lsp;
+
+    static const meta::plugin_t *variants[] =
+    {
+        &meta::ab_tester_x2_stereo,
+        &meta::ab_tester_x8_stereo,
+        NULL
+    };
+}
+
+/*
+ * Compares the interleaved processing path against the planar one that
+ * requires the host to deinterleave inputs and interleave outputs
+ */
+PTEST_BEGIN("ab_tester", interleaved, 5, 1000)
+
+    void planar(const char *label, test::offline_host *host,
+        float *dst, const float *src, float *tmp, size_t count)
+    {
+        const size_t inputs     = host->inputs();
+        const size_t outputs    = host->outputs();
+        float *vin              = tmp;
+        float *vout             = &tmp[inputs << MAX_RANK];
+
+        for (size_t i=0; i<inputs; ++i)
+            host->bind_input(i, &vin[i << MAX_RANK]);
+        for (size_t i=0; i<outputs; ++i)
+            host->bind_output(i, &vout[i << MAX_RANK]);
+
+        printf("Testing %s on %d samples...\n", label, int(count));
+
+        PTEST_LOOP(label,
+            // Deinterleave the input data
+            for (size_t i=0; i<inputs; ++i)
+            {
+                float *d        = &vin[i << MAX_RANK];
+                const float *s  = &src[i];
+                for (size_t j=0; j<count; ++j, s += inputs)
+                    d[j]            = *s;
+            }
+
+            host->process(count);
+
+            // Interleave the output data
+            for (size_t i=0; i<outputs; ++i)
+            {
+                const float *s  = &vout[i << MAX_RANK];
+                float *d        = &dst[i];
+                for (size_t j=0; j<count; ++j, d += outputs)
+                    *d              = s[j];
+            }
+        );
+    }
+
+    void interleaved(const char *label, test::offline_host *host,
+        float *dst, const float *src, size_t count)
+    {
+        printf("Testing %s on %d samples...\n", label, int(count));
+
+        PTEST_LOOP(label,
+            host->process_interleaved(dst, src, count);
+        );
+    }
+
+    PTEST_MAIN
+    {
+        dsp::init();
+
+        for (const meta::plugin_t * const *v = variants; *v != NULL; ++v)
+        {
+            test::offline_host host;
+            PTEST_ASSERT(host.init(*v, 48000) == STATUS_OK);
+            host.set("sel", 1.0f);
+
+            const size_t inputs     = host.inputs();
+            const size_t outputs    = host.outputs();
+            const size_t frames     = 1 << MAX_RANK;
+
+            uint8_t *data           = NULL;
+            float *src              = alloc_aligned<float>(data, (inputs * 2 + outputs * 2) * frames, 64);
+            PTEST_ASSERT(src != NULL);
+            lsp_finally { free_aligned(data); };
+
+            float *dst              = &src[inputs * frames];
+            float *tmp              = &dst[outputs * frames];
+            randomize_sign(src, inputs * frames);
+
+            for (size_t i=MIN_RANK; i <= MAX_RANK; i += 2)
+            {
+                const size_t count = 1 << i;
+                char buf[80];
+
+                snprintf(buf, sizeof(buf), "%s planar x%d", (*v)->uid, int(count));
+                planar(buf, &host, dst, src, tmp, count);
+
+                snprintf(buf, sizeof(buf), "%s interleaved x%d", (*v)->uid, int(count));
+                interleaved(buf, &host, dst, src, count);
+
+                PTEST_SEPARATOR;
+            }
+
+            PTEST_SEPARATOR2;
+        }
+    }
+
+PTEST_END
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/runtime/system.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/test-fw/ptest.h>
+
+#include <private/meta/ab_tester.h>
+#include <private/test/offline_host.h>
+
+#if defined(ARCH_X86)
+    #include <x86intrin.h>
+#endif /* ARCH_X86 */
+
+#define MIN_BLOCK       16
+#define MAX_BLOCK       8192
+#define MIN_TIME        200     /* Minimum measurement time for each case in milliseconds */
+
+namespace
+{
+    using namespace lsp;
+
+    static const meta::plugin_t *variants[] =
+    {
+        &meta::ab_tester_x2_mono,
+        &meta::ab_tester_x4_mono,
+        &meta::ab_tester_x8_mono,
+        &meta::ab_tester_x2_stereo,
+        &meta::ab_tester_x4_stereo,
+        &meta::ab_tester_x8_stereo,
+        NULL
+    };
+
+    typedef struct scenario_t
+    {
+        const char     *name;
+        bool            returns;    // Returns are connected
+        bool            blind;      // Blind test mode is on
+        bool            mono;       // Mono switch is on
+        bool            xfade;      // Selector and gains change on each block
+    } scenario_t;
+
+    static const scenario_t scenarios[] =
+    {
+        { "plain",      false,  false,  false,  false   },
+        { "returns",    true,   false,  false,  false   },
+        { "blind",      false,  true,   false,  false   },
+        { "mono",       false,  false,  true,   false   },
+        { "crossfade",  false,  false,  false,  true    },
+        { NULL,         false,  false,  false,  false   }
+    };
+
+    static inline uint64_t read_cycles()
+    {
+    #if defined(ARCH_X86)
+        return __rdtsc();
+    #else
+        return 0;
+    #endif /* ARCH_X86 */
+    }
+}
+
+/*
+ * Measures ab_tester::process() for all plugin variants, block sizes and
+ * processing modes. Reports the time and the number of CPU cycles per sample.
+ */
+PTEST_BEGIN("ab_tester", process, 5, 1000)
+
+    void measure(const meta::plugin_t *meta, const scenario_t *sc, float *buf, core::AudioBuffer *ret)
+    {
+        test::offline_host host;
+        PTEST_ASSERT(host.init(meta, 48000) == STATUS_OK);
+
+        const size_t inputs     = host.inputs();
+        const size_t outputs    = host.outputs();
+        const size_t returns    = host.returns();
+
+        for (size_t i=0; i<inputs; ++i)
+            host.bind_input(i, &buf[i * MAX_BLOCK]);
+        for (size_t i=0; i<outputs; ++i)
+            host.bind_output(i, &buf[(inputs + i) * MAX_BLOCK]);
+        for (size_t i=0; i<returns; ++i)
+            host.bind_return(i, &ret[i]);
+        for (size_t i=0; i<returns; ++i)
+            ret[i].set_active(sc->returns);
+
+        host.set("sel", 1.0f);
+        host.set("bte", (sc->blind) ? 1.0f : 0.0f);
+        host.set("mono", (sc->mono) ? 1.0f : 0.0f);
+
+        for (size_t block=MIN_BLOCK; block <= MAX_BLOCK; block <<= 2)
+        {
+            // Warm up the caches
+            for (size_t i=0; i<16; ++i)
+                host.process(block);
+
+            // Measure
+            size_t iterations           = 0;
+            uint64_t cycles             = 0;
+            system::time_millis_t start = system::get_time_millis();
+            system::time_millis_t time  = 0;
+
+            do
+            {
+                for (size_t i=0; i<64; ++i, ++iterations)
+                {
+                    if (sc->xfade)
+                    {
+                        host.set("sel", (iterations & 1) + 1);
+                        host.set("g_1", (iterations & 1) ? 0.5f : 1.0f);
+                    }
+
+                    uint64_t t0         = read_cycles();
+                    host.process(block);
+                    cycles             += read_cycles() - t0;
+                }
+                time        = system::get_time_millis() - start;
+            } while (time < MIN_TIME);
+
+            const double samples    = double(iterations) * block;
+            const double ns         = (time * 1e+6) / samples;
+            const double cps        = double(cycles) / samples;
+
+            if (cycles > 0)
+                printf("%-24s %-10s %5d: %8.3f ns/sample, %8.3f cycles/sample\n",
+                    meta->uid, sc->name, int(block), ns, cps);
+            else
+                printf("%-24s %-10s %5d: %8.3f ns/sample\n",
+                    meta->uid, sc->name, int(block), ns);
+        }
+    }
+
+    PTEST_MAIN
+    {
+        dsp::init();
+
+        // Allocate buffers for up to 16 inputs and 2 outputs
+        const size_t channels   = 16 + 2;
+        uint8_t *data           = NULL;
+        float *buf              = alloc_aligned<float>(data, channels * MAX_BLOCK, 64);
+        PTEST_ASSERT(buf != NULL);
+        lsp_finally { free_aligned(data); };
+        randomize_sign(buf, channels * MAX_BLOCK);
+
+        // Allocate return buffers
+        core::AudioBuffer ret[16];
+        for (size_t i=0; i<16; ++i)
+        {
+            ret[i].set_size(MAX_BLOCK);
+            PTEST_ASSERT(ret[i].buffer() != NULL);
+            randomize_sign(ret[i].buffer(), MAX_BLOCK);
+        }
+
+        for (const meta::plugin_t * const *v = variants; *v != NULL; ++v)
+        {
+            for (const scenario_t *sc = scenarios; sc->name != NULL; ++sc)
+            {
+                // Mono switch is available only for stereo variants
+                if ((sc->mono) && (!meta::is_audio_out_port(&(*v)->ports[1])))
+                    continue;
+
+                measure(*v, sc, buf, ret);
+                PTEST_SEPARATOR;
+            }
+            PTEST_SEPARATOR2;
+        }
+    }
+
+PTEST_END
@@ -0,0 +1,344 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-ab-tester
+ * Created on: 19 окт. 2026 г.
+ *
+ * lsp-plugins-ab-tester is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-ab-tester is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-ab-tester. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/ctl/Bypass.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/test-fw/utest.h>
+
+#include <private/meta/ab_tester.h>
+#include <private/plugins/gain_smoother.h>
+#include <private/plugins/process_timer.h>
+#include <private/test/offline_host.h>
+
+/*
+ * Golden-render regression test.
+ *
+ * Renders deterministic stimuli through each plugin variant and through the
+ * straightforward reference implementation of the mixing path, and compares
+ * them sample by sample. Any optimization of ab_tester::process() should keep
+ * this test passing. The speedup against the reference implementation is
+ * reported for each case.
+ */
+
+#define MAX_BLOCK       1024    /* Should not exceed the internal buffer of the plugin */
+#define MAX_CHANNELS    16
+#define CALLS           2000
+#define SAMPLE_RATE     48000
+#define TOLERANCE       1e-5f
+
+namespace
+{
+    using namespace lsp;
+
+    static const meta::plugin_t *variants[] =
+    {
+        &meta::ab_tester_x2_mono,
+        &meta::ab_tester_x4_mono,
+        &meta::ab_tester_x8_mono,
+        &meta::ab_tester_x2_stereo,
+        &meta::ab_tester_x4_stereo,
+        &meta::ab_tester_x8_stereo,
+        NULL
+    };
+
+    typedef struct scenario_t
+    {
+        const char     *name;
+        bool            sweep;      // Sweep the selector
+        bool            ramp;       // Change gains
+        bool            returns;    // Returns are connected
+        bool            mono;       // Mono switch is on
+        bool            blind;      // Blind test mode is on
+    } scenario_t;
+
+    static const scenario_t scenarios[] =
+    {
+        { "sweep",      true,   false,  false,  false,  false   },
+        { "ramp",       false,  true,   false,  false,  false   },
+        { "returns",    true,   true,   true,   false,  false   },
+        { "mono",       true,   true,   false,  true,   false   },
+        { "blind",      true,   true,   true,   false,  true    },
+        { NULL,         false,  false,  false,  false,  false   }
+    };
+
+    /**
+     * Reference implementation of the mixing path: per-sample gain ramp of the
+     * fixed length that spans blocks, return mixing, bypass, summing to the
+     * output and mono switch
+     */
+    typedef struct reference_t
+    {
+        dspu::Bypass    vBypass[MAX_CHANNELS];
+        float           vStart[MAX_CHANNELS];
+        float           vTarget[MAX_CHANNELS];
+        size_t          vPos[MAX_CHANNELS];
+        size_t          nRamp;
+        size_t          nInputs;
+        size_t          nOutputs;
+        bool            bMono;
+    } reference_t;
+
+    static void ref_init(reference_t *ref, size_t inputs, size_t outputs)
+    {
+        ref->nInputs        = inputs;
+        ref->nOutputs       = outputs;
+        ref->bMono          = false;
+        ref->nRamp          = dspu::seconds_to_samples(SAMPLE_RATE, plugins::gain_smoother::SMOOTH_TIME);
+        for (size_t i=0; i<inputs; ++i)
+        {
+            ref->vBypass[i].init(SAMPLE_RATE);
+            ref->vStart[i]      = GAIN_AMP_0_DB;
+            ref->vTarget[i]     = GAIN_AMP_0_DB;
+            ref->vPos[i]        = ref->nRamp;
+        }
+    }
+
+    static float ref_gain(const reference_t *ref, size_t i)
+    {
+        if (ref->vPos[i] >= ref->nRamp)
+            return ref->vTarget[i];
+        return ref->vStart[i] + (ref->vTarget[i] - ref->vStart[i]) * ref->vPos[i] / ref->nRamp;
+    }
+
+    static void ref_update(reference_t *ref, test::offline_host *host)
+    {
+        char id[32];
+        const size_t selector   = host->port("sel")->value();
+        test::offline_port *mono= host->port("mono");
+        ref->bMono              = (mono != NULL) && (mono->value() >= 0.5f);
+
+        for (size_t i=0; i<ref->nInputs; ++i)
+        {
+            const size_t chan_id    = (i / ref->nOutputs) + 1;
+            snprintf(id, sizeof(id), "g_%d", int(chan_id));
+
+            const float gain        = host->port(id)->value();
+            if (gain != ref->vTarget[i])
+            {
+                ref->vStart[i]          = ref_gain(ref, i);
+                ref->vTarget[i]         = gain;
+                ref->vPos[i]            = 0;
+            }
+            ref->vBypass[i].set_bypass(selector != chan_id);
+        }
+    }
+
+    static void ref_process(reference_t *ref, float **out, float * const *in, float * const *ret, float *tmp, size_t samples)
+    {
+        for (size_t i=0; i<ref->nOutputs; ++i)
+            for (size_t j=0; j<samples; ++j)
+                out[i][j]       = 0.0f;
+
+        for (size_t i=0; i<ref->nInputs; ++i)
+        {
+            for (size_t j=0; j<samples; ++j)
+            {
+                const float k       = ref_gain(ref, i);
+                tmp[j]              = in[i][j] * k;
+                if (ret[i] != NULL)
+                    tmp[j]             += ret[i][j] * k;
+                if (ref->vPos[i] < ref->nRamp)
+                    ++ref->vPos[i];
+            }
+
+            ref->vBypass[i].process(tmp, NULL, tmp, samples);
+
+            float *dst          = out[i % ref->nOutputs];
+            for (size_t j=0; j<samples; ++j)
+                dst[j]             += tmp[j];
+        }
+
+        if ((ref->nOutputs > 1) && (ref->bMono))
+        {
+            for (size_t j=0; j<samples; ++j)
+            {
+                const float m       = (out[0][j] + out[1][j]) * 0.5f;
+                out[0][j]           = m;
+                out[1][j]           = m;
+            }
+        }
+    }
+
+    // Deterministic pseudo-random generator, does not depend on the C library
+    static inline float next_random(uint32_t *state)
+    {
+        *state              = (*state) * 1664525U + 1013904223U;
+        return float(int32_t(*state)) / 2147483648.0f;
+    }
+
+    static void generate(float *dst, size_t channel, size_t offset, size_t samples, uint32_t *state)
+    {
+        const float freq    = (2.0f * M_PI * (110.0f * (channel + 1))) / SAMPLE_RATE;
+        for (size_t i=0; i<samples; ++i)
+            dst[i]              = 0.5f * sinf(freq * (offset + i)) + 0.1f * next_random(state);
+    }
+}
+
+UTEST_BEGIN("ab_tester", golden)
+
+    void render(const meta::plugin_t *meta, const scenario_t *sc, float *buf)
+    {
+        test::offline_host host;
+        UTEST_ASSERT(host.init(meta, SAMPLE_RATE) == STATUS_OK);
+
+        const size_t inputs     = host.inputs();
+        const size_t outputs    = host.outputs();
+        const size_t returns    = host.returns();
+        const size_t candidates = inputs / outputs;
+        UTEST_ASSERT(inputs <= MAX_CHANNELS);
+        UTEST_ASSERT(returns == inputs);
+
+        // Mono switch is available only for stereo variants
+        if ((sc->mono) && (outputs < 2))
+            return;
+
+        // Bind buffers
+        float *vin[MAX_CHANNELS], *vret[MAX_CHANNELS], *vout[2], *vref[2];
+        float *tmp              = buf;
+        core::AudioBuffer ret[MAX_CHANNELS];
+        buf                    += MAX_BLOCK;
+
+        for (size_t i=0; i<inputs; ++i, buf += MAX_BLOCK)
+        {
+            vin[i]                  = buf;
+            host.bind_input(i, vin[i]);
+        }
+        for (size_t i=0; i<outputs; ++i)
+        {
+            vout[i]                 = buf;
+            vref[i]                 = &buf[MAX_BLOCK];
+            buf                    += MAX_BLOCK * 2;
+            host.bind_output(i, vout[i]);
+        }
+        for (size_t i=0; i<returns; ++i)
+        {
+            ret[i].set_size(MAX_BLOCK);
+            UTEST_ASSERT(ret[i].buffer() != NULL);
+            ret[i].set_active(sc->returns);
+            vret[i]                 = (sc->returns) ? ret[i].buffer() : NULL;
+            host.bind_return(i, &ret[i]);
+        }
+
+        // Initial state
+        reference_t *ref        = new reference_t;
+        UTEST_ASSERT(ref != NULL);
+        lsp_finally { delete ref; };
+        ref_init(ref, inputs, outputs);
+
+        host.set("sel", 1.0f);
+        host.set("bte", (sc->blind) ? 1.0f : 0.0f);
+        if (outputs > 1)
+            host.set("mono", (sc->mono) ? 1.0f : 0.0f);
+        host.update_settings();
+        ref_update(ref, &host);
+
+        // Render
+        uint32_t state          = 0x5eed;
+        size_t offset           = 0;
+        uint64_t time_plugin    = 0;
+        uint64_t time_ref       = 0;
+        char id[32];
+
+        for (size_t call=0; call<CALLS; ++call)
+        {
+            // Change parameters
+            bool update             = false;
+            if ((sc->sweep) && ((call % 16) == 0))
+            {
+                host.set("sel", (call / 16) % (candidates + 1));
+                update                  = true;
+            }
+            if ((sc->ramp) && ((call % 3) == 0))
+            {
+                snprintf(id, sizeof(id), "g_%d", int((call / 3) % candidates) + 1);
+                host.set(id, 0.5f + 0.5f * next_random(&state));
+                update                  = true;
+            }
+            if (update)
+            {
+                host.update_settings();
+                ref_update(ref, &host);
+            }
+
+            // Generate stimuli
+            const size_t block      = ((call * 7919) % MAX_BLOCK) + 1;
+            for (size_t i=0; i<inputs; ++i)
+            {
+                generate(vin[i], i, offset, block, &state);
+                if (vret[i] != NULL)
+                    generate(vret[i], i + inputs, offset, block, &state);
+            }
+
+            // Process
+            uint64_t t0             = plugins::process_timer::now();
+            host.process(block);
+            uint64_t t1             = plugins::process_timer::now();
+            ref_process(ref, vref, vin, vret, tmp, block);
+            uint64_t t2             = plugins::process_timer::now();
+
+            time_plugin            += t1 - t0;
+            time_ref               += t2 - t1;
+
+            // Compare
+            for (size_t i=0; i<outputs; ++i)
+            {
+                for (size_t j=0; j<block; ++j)
+                {
+                    const float a           = vout[i][j];
+                    const float b           = vref[i][j];
+                    const float tol         = TOLERANCE * lsp_max(1.0f, fabsf(b));
+                    if (fabsf(a - b) > tol)
+                    {
+                        UTEST_FAIL_MSG("%s/%s: output %d differs at call %d, sample %d: %.8f vs %.8f",
+                            meta->uid, sc->name, int(i), int(call), int(j), a, b);
+                    }
+                }
+            }
+
+            offset                 += block;
+        }
+
+        printf("%-24s %-10s: %d samples, speedup against reference x%.2f\n",
+            meta->uid, sc->name, int(offset),
+            (time_plugin > 0) ? double(time_ref) / double(time_plugin) : 0.0);
+    }
+
+    UTEST_MAIN
+    {
+        dsp::init();
+
+        // Temporary buffer, inputs, outputs and reference outputs
+        const size_t channels   = 1 + MAX_CHANNELS + 2 * 2;
+        uint8_t *data           = NULL;
+        float *buf              = alloc_aligned<float>(data, channels * MAX_BLOCK, 64);
+        UTEST_ASSERT(buf != NULL);
+        lsp_finally { free_aligned(data); };
+
+        for (const meta::plugin_t * const *v = variants; *v != NULL; ++v)
+            for (const scenario_t *sc = scenarios; sc->name != NULL; ++sc)
+                render(*v, sc, buf);
+    }
+
+UTEST_END